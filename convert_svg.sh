@@ -1,2 +1,3 @@
 #!/bin/bash
-inkscape --export-filename=res/WordGenerator.svg --export-text-to-path res/WordGeneratorText.svg
\ No newline at end of file
+inkscape --export-filename=res/WordGenerator.svg --export-text-to-path res/WordGeneratorText.svg
+inkscape --export-filename=res/WordExpander.svg --export-text-to-path res/WordExpanderText.svg
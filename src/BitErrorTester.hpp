@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+
+// Bit-error-rate tester: checks the bits coming back from a device under test against the bits
+// that were generated. Each tick only shifts both bits in; the comparison runs once per word,
+// as an XOR and popcount over the word's bits. The delay through the device is found by a sync
+// search over the generated history and held until several words in a row come back mostly wrong.
+struct BitErrorTester {
+    static constexpr int MAX_DELAY = 63;      // Longest round trip through the device, in ticks
+    static constexpr int SYNC_WINDOW = 64;    // Received bits matched against each candidate delay
+    static constexpr int SYNC_MAX_ERRORS = 4; // Mismatches in the window a candidate may have and still lock
+    static constexpr int SYNC_LOSS_WORDS = 4; // Consecutive words with more than half their bits wrong that drop sync
+
+    uint64_t generatedLow = 0;  // Generated bits, newest in bit 0
+    uint64_t generatedHigh = 0; // The 64 generated before those
+    uint64_t received = 0;      // Received bits, newest in bit 0
+    int history = 0;            // Bits shifted in since the restart, up to what the sync search needs
+    int wordBits = 0;           // Bits since the last word boundary
+    int badWords = 0;
+    bool synced = false;
+    int delay = 0;              // Ticks from generating a bit to receiving it, valid while synced
+    uint64_t bitsCompared = 0;  // Since the restart, counted while synced
+    uint64_t bitErrors = 0;
+
+    void restart() { *this = BitErrorTester(); }
+
+    // Shifts in one tick. At the end of a word of `wordLength` bits that was compared, returns its
+    // error count; otherwise -1.
+    int push(bool generatedBit, bool receivedBit, int wordLength) {
+        generatedHigh = (generatedHigh << 1) | (generatedLow >> 63);
+        generatedLow = (generatedLow << 1) | (generatedBit ? 1 : 0);
+        received = (received << 1) | (receivedBit ? 1 : 0);
+        if (history < SYNC_WINDOW + MAX_DELAY) history++;
+        if (++wordBits < wordLength) return -1;
+        wordBits = 0;
+        if (!synced) {
+            searchSync();
+            return -1;
+        }
+        uint64_t mask = (1ull << wordLength) - 1;
+        int errors = __builtin_popcountll((received ^ expected(delay)) & mask);
+        bitsCompared += wordLength;
+        bitErrors += errors;
+        if (2 * errors > wordLength) {
+            if (++badWords >= SYNC_LOSS_WORDS) { synced = false; badWords = 0; }
+        } else {
+            badWords = 0;
+        }
+        return errors;
+    }
+
+    // The generated bits that should be arriving now after a round trip of `ticks`, aligned with `received`
+    uint64_t expected(int ticks) const {
+        return ticks == 0 ? generatedLow : (generatedLow >> ticks) | (generatedHigh << (64 - ticks));
+    }
+
+    // Locks onto the delay whose expected bits best match the last SYNC_WINDOW received bits
+    void searchSync() {
+        if (history < SYNC_WINDOW + MAX_DELAY) return;
+        int bestErrors = SYNC_MAX_ERRORS + 1;
+        for (int ticks = 0; ticks <= MAX_DELAY; ticks++) {
+            int errors = __builtin_popcountll(received ^ expected(ticks));
+            if (errors < bestErrors) { bestErrors = errors; delay = ticks; }
+        }
+        synced = bestErrors <= SYNC_MAX_ERRORS;
+    }
+
+    double errorRate() const { return bitsCompared ? (double)bitErrors / bitsCompared : 0.0; }
+};
@@ -0,0 +1,59 @@
+#include "Bitstream.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool BitstreamFile::open(const std::string& newPath) {
+    close();
+#ifdef _WIN32
+    int wideLength = MultiByteToWideChar(CP_UTF8, 0, newPath.c_str(), -1, nullptr, 0);
+    std::wstring widePath(wideLength, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, newPath.c_str(), -1, &widePath[0], wideLength);
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) { CloseHandle(file); return false; }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file); // The mapping keeps the file open
+    if (!mapping) return false;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { CloseHandle(mapping); return false; }
+    mappingHandle = mapping;
+    data = view;
+    size = (size_t)fileSize.QuadPart;
+#else
+    int fd = ::open(newPath.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) { ::close(fd); return false; }
+    void* mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file open
+    if (mapped == MAP_FAILED) return false;
+    // Playback walks the file front to back: readahead as it goes, without faulting the whole file in up front
+    madvise(mapped, (size_t)st.st_size, MADV_SEQUENTIAL);
+    data = mapped;
+    size = (size_t)st.st_size;
+#endif
+    path = newPath;
+    return true;
+}
+
+void BitstreamFile::close() {
+    if (!data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle((HANDLE)mappingHandle);
+    mappingHandle = nullptr;
+#else
+    munmap(data, size);
+#endif
+    data = nullptr;
+    size = 0;
+    path.clear();
+}
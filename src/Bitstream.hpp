@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a bitstream file for playback. The file is never copied to the
+// heap: pages are faulted in on demand, with the OS told that reads are sequential.
+// Layout is the one tools/wordrender writes: two bits per tick (bit 0 Word A, bit 1 Word B),
+// four ticks per byte, LSB first, read as little-endian 64-bit words.
+struct BitstreamFile {
+    BitstreamFile() {}
+    BitstreamFile(const BitstreamFile&) = delete;
+    BitstreamFile& operator=(const BitstreamFile&) = delete;
+    ~BitstreamFile() { close(); }
+
+    // Returns false, and stays closed, if the file can't be mapped or is empty
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return data != nullptr; }
+    const std::string& getPath() const { return path; }
+    // 64-bit words covering the file. The last one may extend past the end of the file, within
+    // the mapped page, where it reads as zeros.
+    const uint64_t* words() const { return static_cast<const uint64_t*>(data); }
+    uint64_t ticks() const { return (uint64_t)size * 4; }
+
+private:
+    void* data = nullptr;
+    size_t size = 0;
+    std::string path;
+#ifdef _WIN32
+    void* mappingHandle = nullptr;
+#endif
+};
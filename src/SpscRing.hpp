@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// Bounded single-producer/single-consumer queue. One thread pushes and one other thread pops;
+// neither allocates nor blocks. CAPACITY must be a power of two.
+template <typename T, size_t CAPACITY>
+struct SpscRing {
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "SpscRing capacity must be a power of two");
+
+    // Producer side. Drops the item and returns false when the consumer has fallen a full ring behind.
+    bool push(const T& item) {
+        size_t write = writeIndex.load(std::memory_order_relaxed);
+        if (write - readIndex.load(std::memory_order_acquire) >= CAPACITY) return false;
+        items[write & (CAPACITY - 1)] = item;
+        writeIndex.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Hands every queued item to `consume` in order, with one index handoff per batch.
+    template <typename F>
+    size_t drain(F consume) {
+        size_t read = readIndex.load(std::memory_order_relaxed);
+        size_t write = writeIndex.load(std::memory_order_acquire);
+        for (size_t i = read; i != write; i++) consume(items[i & (CAPACITY - 1)]);
+        readIndex.store(write, std::memory_order_release);
+        return write - read;
+    }
+
+private:
+    T items[CAPACITY];
+    // Indices only grow; their difference is the fill level. Padded apart onto separate cache lines
+    // rather than aligned, since over-aligned members would need aligned new for the owning module.
+    static constexpr size_t CACHE_LINE = 64;
+    std::atomic<size_t> writeIndex{0};
+    char writePadding[CACHE_LINE];
+    std::atomic<size_t> readIndex{0};
+    char readPadding[CACHE_LINE];
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include "WordEngine.hpp"
+
+// Expander bus between a WordGenerator and the WordExpanders chained to its right.
+//
+// Both messages live in the double buffers of the WordGenerator and of each expander, and are
+// written in place by the far end rather than relayed hop by hop: an expander walks left to
+// the master and writes its bank into the master's right producer message, and the master
+// writes each expander's display data straight into that expander's left producer message.
+// Chains of any length therefore see one sample of latency and no per-hop copies.
+
+static constexpr int MAX_EXPANDERS = WordEngine::MAX_BANKS - 1;
+
+// Expander banks towards the master. Slot k - 1 belongs to the k-th expander from the master.
+struct WordBankMessage {
+    uint16_t wordA_switches[MAX_EXPANDERS] = {};
+    uint16_t wordB_switches[MAX_EXPANDERS] = {};
+};
+
+// Master state towards one expander, refreshed at light rate
+struct WordDisplayMessage {
+    bool connected = false;
+    uint16_t displayWordA = 0; // Bank words after PRN mixing and inversion, channel 1
+    uint16_t displayWordB = 0;
+    int wordLength = 16;
+    bool active = false;       // The bank is the one currently playing
+};
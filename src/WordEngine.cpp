@@ -0,0 +1,373 @@
+#include "WordEngine.hpp"
+#include <climits>
+#include <cmath>
+
+namespace {
+
+// splitmix64 step, so that nearby seeds give unrelated streams
+uint64_t splitmix64(uint64_t& state) {
+    state += 0x9e3779b97f4a7c15ull;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+void WordEngine::Random::seed(uint64_t seedValue) {
+    for (int i = 0; i < 2; i++) s[i] = splitmix64(seedValue);
+    if (s[0] == 0 && s[1] == 0) s[0] = 1;
+}
+
+uint32_t WordEngine::Random::bernoulliMask32(uint32_t threshold) {
+    if (threshold == 0) return 0;
+    if (threshold >= 65536) return 0xFFFFFFFF;
+    // Bit-sliced comparison of 32 random 16-bit lanes against the threshold, MSB first.
+    // Each random plane holds one bit of every lane; a lane is decided at its first bit that
+    // differs from the threshold, so all lanes are usually settled after 6-8 planes.
+    uint32_t less = 0;
+    uint32_t equal = 0xFFFFFFFF;
+    uint64_t planes = 0;
+    for (int bit = 15; bit >= 0 && equal; bit--) {
+        if (bit & 1) planes = u64();
+        uint32_t plane = (bit & 1) ? (uint32_t)planes : (uint32_t)(planes >> 32);
+        if (threshold & (1u << bit)) { less |= equal & ~plane; equal &= plane; }
+        else { equal &= ~plane; }
+    }
+    return less;
+}
+
+void WordEngine::reset(const Config& config, uint64_t seed) {
+    currentStep = 0; clockPhase = 0.f; forceSingleCycle = false; singleCycleComplete = false;
+    clockSamplesElapsed = 0; computeClockSchedule();
+    // Adjacent channel seeds differ in a bit or two, so both streams are derived through splitmix64
+    uint64_t seedState = seed;
+    prnState = (uint32_t)splitmix64(seedState); if (prnState == 0) prnState = PRN_FALLBACK_SEED; // The LFSR locks up at zero
+    prnSeedState = prnState;
+    mixSeed = splitmix64(seedState);
+    tickCount = 0;
+    loadPrnPatterns();
+    streamPosition = 0;
+    if (config.streamWords) loadStreamWords(config);
+    const uint16_t* sourceA = sourceWordsA(config);
+    const uint16_t* sourceB = sourceWordsB(config);
+    for (int bank = 0; bank < MAX_BANKS; bank++) {
+        stepFinalWordA[bank] = sourceA[bank]; stepFinalWordB[bank] = sourceB[bank];
+    }
+    buildSchedule(config);
+}
+
+void WordEngine::seek(const Config& config, uint64_t tick) {
+    clockPhase = 0.f; clockSamplesElapsed = 0; computeClockSchedule();
+    forceSingleCycle = false; singleCycleComplete = false;
+    uint64_t seqLen = (uint64_t)sequenceLength(config, config.wordLength);
+    currentStep = (int)(tick % seqLen);
+    if (config.streamWords) {
+        // Each completed cycle consumed one segment per bank; the product never exceeds tick
+        streamPosition = (tick / seqLen) * (uint64_t)(config.wordLength * config.banks) % config.streamTicks;
+        loadStreamWords(config);
+    }
+    if (tick == 0) {
+        prnState = prnSeedState;
+        tickCount = 0;
+        loadPrnPatterns();
+        const uint16_t* sourceA = sourceWordsA(config);
+        const uint16_t* sourceB = sourceWordsB(config);
+        for (int bank = 0; bank < MAX_BANKS; bank++) {
+            stepFinalWordA[bank] = sourceA[bank]; stepFinalWordB[bank] = sourceB[bank];
+        }
+    } else {
+        // Land just before the last tick and replay it, which mixes the words that tick left behind
+        prnState = jumpPRN(prnSeedState, (tick - 1) * (uint64_t)config.banks);
+        tickCount = tick - 1;
+        nextStepWords(config);
+    }
+    buildSchedule(config);
+}
+
+int WordEngine::beginSingleCycle(const Config& config, bool immediateFirstStep) {
+    currentStep = 0; cursorBank = 0; cursorBit = 0; forceSingleCycle = true; singleCycleComplete = false;
+    int events = 0;
+    if (config.streamWords) loadStreamWords(config);
+    if (immediateFirstStep) {
+        nextStepWords(config);
+        events |= FIRST_BIT_EVENT;
+        int effectiveSeqLen = sequenceLength(config, config.wordLength);
+        if (0 == effectiveSeqLen - 1) { events |= LAST_BIT_EVENT; singleCycleComplete = true; }
+    }
+    return events;
+}
+
+void WordEngine::updateRunState(const Config& config) {
+    if (forceSingleCycle) { isRunning = !singleCycleComplete; if (singleCycleComplete) forceSingleCycle = false; }
+    else { isRunning = !config.singleRunMode; }
+}
+
+void WordEngine::scheduleClock(float clockFreq, float sampleTime) {
+    clockPhase += clockSamplesElapsed * clockIncrement;
+    clockPhase -= (int)clockPhase;
+    clockSamplesElapsed = 0;
+    clockIncrement = clockFreq * sampleTime;
+    computeClockSchedule();
+}
+
+bool WordEngine::advanceScheduledClock(int samples) {
+    clockSamplesElapsed += samples;
+    if (clockSamplesElapsed < clockSamplesToTick) return false;
+    // Carry the fractional overshoot into the next period, as the per-sample accumulator does
+    float phase = std::max(1.f, clockPhase + clockSamplesElapsed * clockIncrement);
+    clockPhase = phase - (int)phase;
+    clockSamplesElapsed = 0;
+    computeClockSchedule();
+    return true;
+}
+
+void WordEngine::computeClockSchedule() {
+    if (clockIncrement <= 0.f) { clockSamplesToTick = INT_MAX; clockSamplesToFall = INT_MAX; return; }
+    // Smallest n with clockPhase + n * clockIncrement >= threshold
+    clockSamplesToTick = std::max(1, (int)std::ceil((1.f - clockPhase) / clockIncrement));
+    clockSamplesToFall = clockPhase < 0.5f ? (int)std::ceil((0.5f - clockPhase) / clockIncrement) : 0;
+}
+
+int WordEngine::advance(const Config& config) {
+    if (!isRunning) return 0;
+    // In playback the tick that wraps the sequence mixes from the next cycle's words
+    if (config.streamWords && currentStep + 1 >= sequenceLength(config, config.wordLength)) loadStreamWords(config);
+    nextStepWords(config);
+    int events = stepEvents(config);
+    advanceSequence(config);
+    return events;
+}
+
+int WordEngine::advanceInto(const Config& config, const Config& next) {
+    if (!isRunning) return 0;
+    // The next sequence starts over, so playback takes up a fresh cycle's words
+    if (next.streamWords) loadStreamWords(next);
+    nextStepWords(next);
+    int events = stepEvents(config);
+    if ((next.singleRunMode || forceSingleCycle) && singleCycleComplete) return events;
+    currentStep = 0; cursorBank = 0; cursorBit = 0;
+    return events;
+}
+
+int WordEngine::stepEvents(const Config& config) {
+    // Gates fire for the bit at the step being left
+    int events = 0;
+    bool triggerGateA, triggerGateB;
+    scheduledBits(triggerGateA, triggerGateB);
+    if (triggerGateA) events |= GATE_A_EVENT;
+    if (triggerGateB) events |= GATE_B_EVENT;
+
+    if (currentStep == 0) { events |= FIRST_BIT_EVENT; }
+    int effectiveSequenceLength = sequenceLength(config, config.wordLength);
+    if (currentStep == effectiveSequenceLength - 1) { events |= LAST_BIT_EVENT; if (forceSingleCycle) { singleCycleComplete = true; } }
+    return events;
+}
+
+void WordEngine::triggerPulses(int events) {
+    if (events & GATE_A_EVENT) wordAGatePulse.trigger(PULSE_DURATION);
+    if (events & GATE_B_EVENT) wordBGatePulse.trigger(PULSE_DURATION);
+    if (events & FIRST_BIT_EVENT) firstBitPulse.trigger(PULSE_DURATION);
+    if (events & LAST_BIT_EVENT) lastBitPulse.trigger(PULSE_DURATION);
+}
+
+WordEngine::Frame WordEngine::process(const Config& config, float sampleTime) {
+    Frame frame;
+    currentBits(config, frame.bitA, frame.bitB);
+    frame.gateA = wordAGatePulse.process(sampleTime);
+    frame.gateB = wordBGatePulse.process(sampleTime);
+    frame.firstBit = firstBitPulse.process(sampleTime);
+    frame.lastBit = lastBitPulse.process(sampleTime);
+    return frame;
+}
+
+void WordEngine::buildSchedule(const Config& config) {
+    scheduleWordLength = config.wordLength;
+    scheduleIs16BitMode = config.is16BitMode;
+    scheduleInvertA = config.invertA;
+    scheduleInvertB = config.invertB;
+    scheduleBanks = config.banks;
+    scheduleBankSteps = config.wordLength * (config.is16BitMode ? 1 : 2);
+    for (int bank = 0; bank < config.banks; bank++) buildBankSchedule(config, bank);
+    // currentStep may lie past the end after a length change; it plays as if the sequence repeated
+    cursorBank = (currentStep / scheduleBankSteps) % scheduleBanks;
+    cursorBit = currentStep % scheduleBankSteps;
+}
+
+void WordEngine::buildBankSchedule(const Config& config, int bank) {
+    // Banks play one after another. In 32-bit mode each bank plays twice, the second time with
+    // the words swapped: A then B on output A, B then A on output B.
+    uint32_t mask = (1u << config.wordLength) - 1;
+    uint32_t wordA = displayWordA(config, bank) & mask;
+    uint32_t wordB = displayWordB(config, bank) & mask;
+    if (config.is16BitMode) {
+        scheduleA[bank] = wordA;
+        scheduleB[bank] = wordB;
+    } else {
+        scheduleA[bank] = wordA | (wordB << config.wordLength);
+        scheduleB[bank] = wordB | (wordA << config.wordLength);
+    }
+}
+
+size_t WordEngine::renderSteps(const Config& config, uint8_t* out, size_t steps) {
+    for (size_t i = 0; i < steps; i++) {
+        // Bits are taken before the tick, so entry 0 is the step a reset or seek lands on
+        bool bitA, bitB;
+        currentBits(config, bitA, bitB);
+        int shift = (i & 3) * 2;
+        if (shift == 0) out[i >> 2] = 0;
+        out[i >> 2] |= (uint8_t)(((bitA ? 1 : 0) | (bitB ? 2 : 0)) << shift);
+        updateRunState(config);
+        tick(config);
+    }
+    return steps;
+}
+
+size_t WordEngine::renderFrames(const Config& config, float clockFreq, float sampleTime, float* outAB, size_t frames) {
+    for (size_t i = 0; i < frames; i++) {
+        updateRunState(config);
+        if (advanceClock(clockFreq, sampleTime)) tick(config);
+        Frame frame = process(config, sampleTime);
+        outAB[2 * i] = frame.bitA ? 10.f : 0.f;
+        outAB[2 * i + 1] = frame.bitB ? 10.f : 0.f;
+    }
+    return frames;
+}
+
+uint32_t WordEngine::generatePRN(uint32_t state) {
+    uint32_t bit = ((state >> 0) ^ (state >> 1) ^ (state >> 21) ^ (state >> 31)) & 1;
+    return (state >> 1) | (bit << 31);
+}
+
+namespace {
+
+// The LFSR step is linear over GF(2): column j holds the image of state bit j
+struct PrnMatrix {
+    uint32_t columns[32];
+
+    uint32_t apply(uint32_t state) const {
+        uint32_t result = 0;
+        for (int j = 0; j < 32; j++) result ^= columns[j] & (0u - ((state >> j) & 1));
+        return result;
+    }
+};
+
+// powers[k] steps the LFSR 2^k times
+struct PrnJumpTable {
+    PrnMatrix powers[64];
+
+    PrnJumpTable() {
+        for (int j = 0; j < 32; j++) powers[0].columns[j] = WordEngine::generatePRN(1u << j);
+        for (int k = 1; k < 64; k++) {
+            for (int j = 0; j < 32; j++) powers[k].columns[j] = powers[k - 1].apply(powers[k - 1].columns[j]);
+        }
+    }
+};
+
+} // namespace
+
+uint32_t WordEngine::jumpPRN(uint32_t state, uint64_t steps) {
+    static const PrnJumpTable table;
+    for (int k = 0; steps; k++, steps >>= 1) {
+        if (steps & 1) state = table.powers[k].apply(state);
+    }
+    return state;
+}
+
+void WordEngine::nextStepWords(const Config& config) {
+    uint32_t threshold = probabilityThreshold(config.prnProbability);
+    if (threshold == 0) mixStepWords<MIX_SWITCHES>(config, threshold);
+    else if (threshold >= 65536) mixStepWords<MIX_PRN>(config, threshold);
+    else mixStepWords<MIX_RANDOM>(config, threshold);
+}
+
+// Specialised on the probability class so that the common switches-only tick draws nothing
+template <int MIX>
+void WordEngine::mixStepWords(const Config& config, uint32_t threshold) {
+    // Fresh mixing stream per tick, so that seek() can reproduce any tick's draws.
+    // Random::seed() consumes two splitmix64 increments, hence the stride of two.
+    if (MIX == MIX_RANDOM) random.seed(mixSeed + 2 * tickCount * 0x9e3779b97f4a7c15ull);
+    tickCount++;
+    const uint16_t* sourceA = sourceWordsA(config);
+    const uint16_t* sourceB = sourceWordsB(config);
+    // Each bank draws its own LFSR step; bank 0's patterns stay in currentPrnPatternA/B
+    for (int bank = config.banks - 1; bank >= 0; bank--) {
+        prnState = generatePRN(prnState);
+        loadPrnPatterns();
+        if (MIX == MIX_SWITCHES) {
+            stepFinalWordA[bank] = sourceA[bank];
+            stepFinalWordB[bank] = sourceB[bank];
+        } else if (MIX == MIX_PRN) {
+            stepFinalWordA[bank] = currentPrnPatternA;
+            stepFinalWordB[bank] = currentPrnPatternB;
+        } else {
+            // Per bit, take the PRN pattern with the requested probability, else the switch: Word A in the low half of the mask, Word B in the high half
+            uint32_t usePrn = random.bernoulliMask32(threshold);
+            uint16_t usePrnA = usePrn & 0xFFFF; uint16_t usePrnB = usePrn >> 16;
+            stepFinalWordA[bank] = (currentPrnPatternA & usePrnA) | (sourceA[bank] & ~usePrnA);
+            stepFinalWordB[bank] = (currentPrnPatternB & usePrnB) | (sourceB[bank] & ~usePrnB);
+        }
+    }
+    if (scheduleMatches(config)) {
+        for (int bank = 0; bank < config.banks; bank++) buildBankSchedule(config, bank);
+    } else {
+        buildSchedule(config);
+    }
+}
+
+namespace {
+
+// Gathers the even bits of x into the low half: one word's bits out of an interleaved A/B run
+uint32_t evenBits(uint32_t x) {
+    x &= 0x55555555;
+    x = (x | (x >> 1)) & 0x33333333;
+    x = (x | (x >> 2)) & 0x0F0F0F0F;
+    x = (x | (x >> 4)) & 0x00FF00FF;
+    x = (x | (x >> 8)) & 0x0000FFFF;
+    return x;
+}
+
+// `count` ticks (at most 16) of interleaved A/B bits from `position` on
+uint32_t readStreamTicks(const uint64_t* words, uint64_t ticks, uint64_t position, int count) {
+    uint32_t mask = count >= 16 ? 0xFFFFFFFF : (1u << (2 * count)) - 1;
+    if (position + count <= ticks) {
+        // Whole 64-bit loads: the run spans at most two words
+        uint64_t bit = position * 2;
+        uint64_t index = bit >> 6;
+        int shift = bit & 63;
+        uint64_t window = words[index] >> shift;
+        if (shift + 2 * count > 64) window |= words[index + 1] << (64 - shift);
+        return (uint32_t)window & mask;
+    }
+    // The run wraps past the end of the stream, tick by tick
+    uint32_t run = 0;
+    for (int i = 0; i < count; i++) {
+        uint64_t p = (position + i) % ticks;
+        run |= (uint32_t)((words[p >> 5] >> ((p & 31) * 2)) & 3) << (2 * i);
+    }
+    return run;
+}
+
+} // namespace
+
+void WordEngine::loadStreamWords(const Config& config) {
+    for (int bank = 0; bank < config.banks; bank++) {
+        uint32_t run = readStreamTicks(config.streamWords, config.streamTicks, streamPosition, config.wordLength);
+        streamWordA[bank] = (uint16_t)evenBits(run);
+        streamWordB[bank] = (uint16_t)evenBits(run >> 1);
+        streamPosition += config.wordLength;
+        if (streamPosition >= config.streamTicks) streamPosition %= config.streamTicks;
+    }
+}
+
+void WordEngine::advanceSequence(const Config& config) {
+    if ((config.singleRunMode || forceSingleCycle) && singleCycleComplete) { return; }
+    currentStep++;
+    if (++cursorBit >= scheduleBankSteps) {
+        cursorBit = 0;
+        if (++cursorBank >= scheduleBanks) cursorBank = 0;
+    }
+    int effectiveSeqLen = sequenceLength(config, config.wordLength);
+    if (currentStep >= effectiveSeqLen) { currentStep = 0; cursorBank = 0; cursorBit = 0; }
+}
@@ -0,0 +1,241 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+
+// Rack-free sequencing core of the Word Generator.
+// Owns the step counter, the PRN state, the PRN/switch mixing and the first/last/gate
+// pulse timers. The Rack module feeds it one sample at a time; the headless renderer
+// (tools/wordrender.cpp) drives it in large batches without a running engine.
+struct WordEngine {
+    // Same semantics as rack::dsp::PulseGenerator, kept here so the core has no Rack dependency
+    struct PulseTimer {
+        float remaining = 0.f;
+        void reset() { remaining = 0.f; }
+        void trigger(float duration = 1e-3f) { if (duration > remaining) remaining = duration; }
+        bool process(float deltaTime) {
+            if (remaining > 0.f) { remaining -= deltaTime; return true; }
+            return false;
+        }
+    };
+
+    // xoroshiro128++: fast, seedable, and with usable low bits, since the Bernoulli masks
+    // below consume every bit of each draw
+    struct Random {
+        uint64_t s[2] = {0x9e3779b97f4a7c15ull, 0xbf58476d1ce4e5b9ull};
+        void seed(uint64_t seedValue);
+        uint64_t u64() {
+            uint64_t s0 = s[0]; uint64_t s1 = s[1];
+            uint64_t result = rotl(s0 + s1, 17) + s0;
+            s1 ^= s0;
+            s[0] = rotl(s0, 49) ^ s1 ^ (s1 << 21);
+            s[1] = rotl(s1, 28);
+            return result;
+        }
+        uint32_t u32() { return u64() >> 32; }
+        float uniform() { return (u32() >> 8) * 5.9604645e-08f; }
+        // 32 independent bits, each set with probability threshold / 65536 (threshold in 0..65536)
+        uint32_t bernoulliMask32(uint32_t threshold);
+    private:
+        static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+    };
+
+    static uint32_t probabilityThreshold(float probability) { return (uint32_t)(probability * 65536.f + 0.5f); }
+
+    // Bank 0 is the module's own 16x2 switches, further banks come from chained expanders
+    static constexpr int MAX_BANKS = 8;
+
+    // Controls sampled by the caller for the current sample
+    struct Config {
+        uint16_t wordA_switches[MAX_BANKS] = {};
+        uint16_t wordB_switches[MAX_BANKS] = {};
+        int banks = 1;              // Banks played in sequence, each contributing one wordLength segment
+        int wordLength = 16;        // CV-modulated length, 1..16
+        bool is16BitMode = true;
+        bool singleRunMode = false; // RUN_MODE_PARAM set to Single
+        bool invertA = false;
+        bool invertB = false;
+        float prnProbability = 0.f;
+        // Bitstream playback (see Bitstream.hpp): when set, the words come from the stream
+        // instead of the switches, one wordLength segment per bank and word per cycle
+        const uint64_t* streamWords = nullptr;
+        uint64_t streamTicks = 0;   // Stream length in ticks, 2 bits each
+    };
+
+    // Output state after a sample has been processed
+    struct Frame {
+        bool bitA = false;
+        bool bitB = false;
+        bool gateA = false;
+        bool gateB = false;
+        bool firstBit = false;
+        bool lastBit = false;
+    };
+
+    // Pulses fired by a tick, returned so that a caller can drive its own pulse timers
+    enum Events {
+        GATE_A_EVENT = 1 << 0,
+        GATE_B_EVENT = 1 << 1,
+        FIRST_BIT_EVENT = 1 << 2,
+        LAST_BIT_EVENT = 1 << 3,
+    };
+
+    static constexpr float PULSE_DURATION = 0.001f;
+    static constexpr uint32_t PRN_FALLBACK_SEED = 0xabcdef12;
+
+    int currentStep = 0;
+    float clockPhase = 0.f;
+
+    // Event-scheduled internal clock. The phase is only materialised into clockPhase on a
+    // reschedule or a tick; in between the engine just counts samples towards the next event.
+    float clockIncrement = 0.f;  // Phase advance per sample
+    int clockSamplesElapsed = 0; // Samples since clockPhase was materialised
+    int clockSamplesToTick = 0;  // Samples from that point until the phase reaches 1
+    int clockSamplesToFall = 0;  // Samples from that point until the phase reaches 0.5, 0 if already past
+
+    bool isRunning = true;
+    bool singleCycleComplete = false;
+    bool forceSingleCycle = false;
+
+    uint32_t prnState = 0x1;         // LFSR state, stepped once per bank per tick
+    uint32_t prnSeedState = 0x1;     // LFSR state at reset, the origin for seek()
+    uint64_t mixSeed = 0;            // Seed of the PRN/switch mixing, which is reseeded per tick from it
+    uint64_t tickCount = 0;          // Ticks since reset
+    uint16_t currentPrnPatternA = 0; // 16-bit random pattern for Word A for the current step
+    uint16_t currentPrnPatternB = 0; // 16-bit random pattern for Word B for the current step
+    uint16_t stepFinalWordA[MAX_BANKS] = {}; // Word A content per bank (switches or PRN) decided at the last clock tick
+    uint16_t stepFinalWordB[MAX_BANKS] = {}; // Word B content per bank (switches or PRN) decided at the last clock tick
+    uint64_t streamPosition = 0;             // Next stream tick to load in playback
+    uint16_t streamWordA[MAX_BANKS] = {};    // Playback words for the current cycle, standing in for the switches
+    uint16_t streamWordB[MAX_BANKS] = {};
+
+    // Output schedule, so that a step is one table lookup. Per bank, bit i of scheduleA/B is the
+    // output at the bank's i-th step: the word in 16-bit mode, the word then its partner in
+    // 32-bit mode. Rebuilt whenever the words, length, mode, inversion or bank count change.
+    uint32_t scheduleA[MAX_BANKS] = {};
+    uint32_t scheduleB[MAX_BANKS] = {};
+    int scheduleBankSteps = 16;
+    int scheduleBanks = 1;
+    int scheduleWordLength = 0; // Config the schedule was built for, 0 before the first build
+    bool scheduleIs16BitMode = true;
+    bool scheduleInvertA = false;
+    bool scheduleInvertB = false;
+    int cursorBank = 0; // currentStep's position in the schedule
+    int cursorBit = 0;
+
+    PulseTimer firstBitPulse;
+    PulseTimer lastBitPulse;
+    PulseTimer wordAGatePulse;
+    PulseTimer wordBGatePulse;
+    Random random; // Source for the per-bit PRN/switch decisions, keyed by (mixSeed, tickCount)
+
+    // Reseeds the LFSR and the mixing and returns to step 0 with the switch words loaded
+    void reset(const Config& config, uint64_t seed);
+    // Jumps to the state reached after `tick` ticks from the last reset with a constant config,
+    // in O(log tick). The clock phase restarts as on a reset.
+    void seek(const Config& config, uint64_t tick);
+    // Arms a single cycle. With an external clock the first step is produced immediately.
+    void startSingleCycle(const Config& config, bool immediateFirstStep) { triggerPulses(beginSingleCycle(config, immediateFirstStep)); }
+    int beginSingleCycle(const Config& config, bool immediateFirstStep);
+    // Latches whether clock ticks are accepted for this sample
+    void updateRunState(const Config& config);
+    // Internal clock phase accumulator, returns true on a tick
+    bool advanceClock(float clockFreq, float sampleTime) {
+        clockPhase += clockFreq * sampleTime;
+        if (clockPhase >= 1.f) { clockPhase -= (int)clockPhase; return true; }
+        return false;
+    }
+    bool internalClockHigh() const { return clockPhase < 0.5f; }
+    // Changes the rate of the scheduled clock, keeping its current phase
+    void scheduleClock(float clockFreq, float sampleTime);
+    // Advances the scheduled clock, returns true on a tick. Must not be asked to skip past a tick.
+    bool advanceScheduledClock(int samples);
+    bool scheduledClockHigh() const { return clockSamplesElapsed < clockSamplesToFall; }
+    // Phase of the scheduled clock at the current sample
+    float scheduledPhase() const { return std::min(clockPhase + clockSamplesElapsed * clockIncrement, 1.f); }
+    // Samples until the scheduled clock's phase next reaches a multiple of 1 / divisions
+    int samplesToSubdivision(int divisions) const {
+        if (clockIncrement <= 0.f) return INT_MAX;
+        float phase = scheduledPhase() * divisions;
+        return std::max(1, (int)std::ceil((std::floor(phase) + 1.f - phase) / (clockIncrement * divisions)));
+    }
+    // Sub-sample position of an edge in the current sample, in (-1, 0] samples as dsp::MinBlepGenerator expects.
+    // tickOffset() is valid on the sample advanceScheduledClock() ticked, fallOffset() on the sample the clock fell.
+    float tickOffset() const { return clockIncrement > 0.f ? std::max(-1.f, -clockPhase / clockIncrement) : 0.f; }
+    float fallOffset() const {
+        if (clockIncrement <= 0.f) return 0.f;
+        float phase = clockPhase + clockSamplesElapsed * clockIncrement;
+        return std::max(-1.f, std::min(0.f, (0.5f - phase) / clockIncrement));
+    }
+    // Samples until the scheduled clock next ticks or its output falls
+    int samplesToClockEvent() const {
+        int toEvent = clockSamplesToTick - clockSamplesElapsed;
+        if (clockSamplesElapsed < clockSamplesToFall) toEvent = std::min(toEvent, clockSamplesToFall - clockSamplesElapsed);
+        return toEvent;
+    }
+    // Handles one clock tick: new PRN word, gate/first/last pulses, step advance
+    void tick(const Config& config) { triggerPulses(advance(config)); }
+    // Same as tick() but returns the Events instead of triggering the pulse timers
+    int advance(const Config& config);
+    // Same as advance(), but the sequence ends at this tick: the step is left with `config` and the
+    // words for the next step are mixed from `next`, which starts at step 0
+    int advanceInto(const Config& config, const Config& next);
+    void triggerPulses(int events);
+    // Computes the outputs for this sample and advances the pulse timers
+    Frame process(const Config& config, float sampleTime);
+
+    uint16_t displayWordA(const Config& config, int bank = 0) const { return config.invertA ? (uint16_t)~stepFinalWordA[bank] : stepFinalWordA[bank]; }
+    uint16_t displayWordB(const Config& config, int bank = 0) const { return config.invertB ? (uint16_t)~stepFinalWordB[bank] : stepFinalWordB[bank]; }
+    // Steps in one full cycle: wordLength per bank, doubled in 32-bit mode
+    static int sequenceLength(const Config& config, int wordLength) { return wordLength * config.banks * (config.is16BitMode ? 1 : 2); }
+    // Steps one bank plays for before the next word starts
+    static int wordSteps(const Config& config) { return config.wordLength * (config.is16BitMode ? 1 : 2); }
+    // Bank a step plays from
+    static int stepBank(const Config& config, int step) {
+        int segment = step / config.wordLength;
+        return (config.is16BitMode ? segment : segment / 2) % config.banks;
+    }
+    // Output bits at currentStep, rebuilding the schedule first if the config moved
+    void currentBits(const Config& config, bool& bitA, bool& bitB) {
+        updateSchedule(config);
+        scheduledBits(bitA, bitB);
+    }
+    void updateSchedule(const Config& config) { if (!scheduleMatches(config)) buildSchedule(config); }
+
+    // Batch rendering for the headless renderer.
+    // renderSteps() emits one tick per step, two bits per step (bit 0: Word A, bit 1: Word B)
+    // packed four steps to a byte, LSB first, starting with the current step. Returns the number of steps written.
+    size_t renderSteps(const Config& config, uint8_t* out, size_t steps);
+    // renderFrames() runs the internal clock and writes interleaved A/B CV voltages.
+    size_t renderFrames(const Config& config, float clockFreq, float sampleTime, float* outAB, size_t frames);
+
+    static uint32_t generatePRN(uint32_t state);
+    // generatePRN() applied `steps` times, through precomputed GF(2) powers of its transition matrix
+    static uint32_t jumpPRN(uint32_t state, uint64_t steps);
+
+private:
+    void computeClockSchedule();
+    bool scheduleMatches(const Config& config) const {
+        return config.wordLength == scheduleWordLength && config.is16BitMode == scheduleIs16BitMode && config.banks == scheduleBanks
+            && config.invertA == scheduleInvertA && config.invertB == scheduleInvertB;
+    }
+    void buildSchedule(const Config& config);
+    void buildBankSchedule(const Config& config, int bank);
+    void scheduledBits(bool& bitA, bool& bitB) const {
+        bitA = (scheduleA[cursorBank] >> cursorBit) & 1;
+        bitB = (scheduleB[cursorBank] >> cursorBit) & 1;
+    }
+    const uint16_t* sourceWordsA(const Config& config) const { return config.streamWords ? streamWordA : config.wordA_switches; }
+    const uint16_t* sourceWordsB(const Config& config) const { return config.streamWords ? streamWordB : config.wordB_switches; }
+    // Reads the next cycle's playback words, wrapping at the end of the stream
+    void loadStreamWords(const Config& config);
+    void loadPrnPatterns() { currentPrnPatternA = prnState & 0xFFFF; currentPrnPatternB = (prnState >> 16) & 0xFFFF; }
+    enum MixMode { MIX_SWITCHES, MIX_RANDOM, MIX_PRN };
+    void nextStepWords(const Config& config);
+    template <int MIX>
+    void mixStepWords(const Config& config, uint32_t threshold);
+    int stepEvents(const Config& config);
+    void advanceSequence(const Config& config);
+};
@@ -0,0 +1,86 @@
+#include "WordExpander.hpp"
+
+using namespace rack;
+
+WordExpander::WordExpander() {
+    config(NUM_PARAMS, NUM_INPUTS, NUM_OUTPUTS, NUM_LIGHTS);
+    
+    for (int i = 0; i < 16; i++) {
+        configSwitch(BIT_A_PARAMS + i, 0, 1, 0, string::f("Word A Bit %d", i + 1));
+        configSwitch(BIT_B_PARAMS + i, 0, 1, 0, string::f("Word B Bit %d", i + 1));
+    }
+    
+    leftExpander.producerMessage = &displayMessages[0];
+    leftExpander.consumerMessage = &displayMessages[1];
+    controlDivider.setDivision(CONTROL_DIVISION);
+    lightDivider.setDivision(LIGHT_DIVISION);
+}
+
+void WordExpander::process(const ProcessArgs& args) {
+    if (controlDivider.process()) {
+        uint16_t current_wordA_switches = 0;
+        uint16_t current_wordB_switches = 0;
+        for (int i = 0; i < 16; i++) {
+            if (params[BIT_A_PARAMS + i].getValue() > 0.5f) current_wordA_switches |= (1 << i);
+            if (params[BIT_B_PARAMS + i].getValue() > 0.5f) current_wordB_switches |= (1 << i);
+        }
+        wordA_switches = current_wordA_switches;
+        wordB_switches = current_wordB_switches;
+    }
+
+    // Walk left past other expanders to the master; our bank goes straight into its bus message.
+    // Written every sample, since the other expanders flip the same double buffer every sample.
+    Module* master = leftExpander.module;
+    int newPosition = 1;
+    while (master && master->model == modelWordExpander && newPosition <= MAX_EXPANDERS) {
+        master = master->leftExpander.module;
+        newPosition++;
+    }
+    if (master && master->model == modelWordGenerator && newPosition <= MAX_EXPANDERS) {
+        WordBankMessage* message = static_cast<WordBankMessage*>(master->rightExpander.producerMessage);
+        message->wordA_switches[newPosition - 1] = wordA_switches;
+        message->wordB_switches[newPosition - 1] = wordB_switches;
+        master->rightExpander.requestMessageFlip();
+        position = newPosition;
+    } else {
+        position = 0;
+    }
+
+    if (lightDivider.process()) updateLights();
+}
+
+void WordExpander::updateLights() {
+    const WordDisplayMessage* display = static_cast<const WordDisplayMessage*>(leftExpander.consumerMessage);
+    bool linked = position > 0 && display->connected;
+    lights[LINK_LIGHT].setBrightness(linked ? (display->active ? 1.f : 0.3f) : 0.f);
+    for (int i = 0; i < 16; ++i) {
+        if (!linked || i >= display->wordLength) { lights[BIT_A_LIGHTS + i].setBrightness(0.1f); lights[BIT_B_LIGHTS + i].setBrightness(0.1f); }
+        else { lights[BIT_A_LIGHTS + i].setBrightness((display->displayWordA & (1 << i)) ? 1.f : 0.f); lights[BIT_B_LIGHTS + i].setBrightness((display->displayWordB & (1 << i)) ? 1.f : 0.f); }
+    }
+}
+
+struct WordExpanderWidget : ModuleWidget {
+    WordExpanderWidget(WordExpander* module) {
+        setModule(module);
+        setPanel(createPanel(asset::plugin(pluginInstance, "res/WordExpander.svg")));
+        
+        addChild(createWidget<ScrewSilver>(Vec(RACK_GRID_WIDTH, 0)));
+        addChild(createWidget<ScrewSilver>(Vec(box.size.x - 2 * RACK_GRID_WIDTH, 0)));
+        addChild(createWidget<ScrewSilver>(Vec(RACK_GRID_WIDTH, RACK_GRID_HEIGHT - RACK_GRID_WIDTH)));
+        addChild(createWidget<ScrewSilver>(Vec(box.size.x - 2 * RACK_GRID_WIDTH, RACK_GRID_HEIGHT - RACK_GRID_WIDTH)));
+        
+        addChild(createLightCentered<MediumLight<GreenLight>>(mm2px(Vec(15, 20)), module, WordExpander::LINK_LIGHT));
+
+        // Bit rows at the same heights as the Word Generator's
+        float bitSwitchStartX = 11.f;
+        float bitSwitchSpacingX = 8.f;
+        for (int i = 0; i < 16; i++) {
+            addParam(createParamCentered<CKSS>(mm2px(Vec(bitSwitchStartX + i * bitSwitchSpacingX, 96.f)), module, WordExpander::BIT_A_PARAMS + i));
+            addChild(createLightCentered<SmallLight<GreenLight>>(mm2px(Vec(bitSwitchStartX + i * bitSwitchSpacingX, 98.5f)), module, WordExpander::BIT_A_LIGHTS + i));
+            addParam(createParamCentered<CKSS>(mm2px(Vec(bitSwitchStartX + i * bitSwitchSpacingX, 118.f)), module, WordExpander::BIT_B_PARAMS + i));
+            addChild(createLightCentered<SmallLight<GreenLight>>(mm2px(Vec(bitSwitchStartX + i * bitSwitchSpacingX, 120.5f)), module, WordExpander::BIT_B_LIGHTS + i));
+        }
+    }
+};
+
+Model* modelWordExpander = createModel<WordExpander, WordExpanderWidget>("WordExpander");
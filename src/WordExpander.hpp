@@ -0,0 +1,52 @@
+#pragma once
+#include "plugin.hpp"
+#include "WordBus.hpp"
+
+// Adds a 16x2 bit bank to the WordGenerator on its left, directly or through other expanders.
+// The master keeps the single step counter and PRN state; see WordBus.hpp for the messages.
+struct WordExpander : rack::Module {
+    enum ParamIds {
+        BIT_A_PARAMS,
+        BIT_A_PARAMS_LAST = BIT_A_PARAMS + 15,
+        BIT_B_PARAMS,
+        BIT_B_PARAMS_LAST = BIT_B_PARAMS + 15,
+        NUM_PARAMS
+    };
+    
+    enum InputIds {
+        NUM_INPUTS
+    };
+    
+    enum OutputIds {
+        NUM_OUTPUTS
+    };
+    
+    enum LightIds {
+        BIT_A_LIGHTS,
+        BIT_A_LIGHTS_LAST = BIT_A_LIGHTS + 15,
+        BIT_B_LIGHTS,
+        BIT_B_LIGHTS_LAST = BIT_B_LIGHTS + 15,
+        LINK_LIGHT,
+        NUM_LIGHTS
+    };
+    
+    static constexpr int CONTROL_DIVISION = 16;
+    static constexpr int LIGHT_DIVISION = 512;
+
+    // Module state
+    uint16_t wordA_switches = 0;
+    uint16_t wordB_switches = 0;
+    int position = 0; // 1 for the expander next to the master, 0 when not linked
+    
+    WordDisplayMessage displayMessages[2]; // Left expander buffers, written by the master
+    dsp::ClockDivider controlDivider;
+    dsp::ClockDivider lightDivider;
+    
+    WordExpander();
+    void process(const ProcessArgs& args) override;
+    
+private:
+    void updateLights();
+};
+
+extern rack::Model* modelWordExpander;
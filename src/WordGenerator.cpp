@@ -1,4 +1,7 @@
 #include "WordGenerator.hpp"
+#include <chrono>
+#include <climits>
+#include <osdialog.h>
 
 using namespace rack;
 
@@ -20,14 +23,13 @@ WordGenerator::WordGenerator() {
     configSwitch(INVERT_A_PARAM, 0, 1, 0, "Invert Word A");
     configSwitch(INVERT_B_PARAM, 0, 1, 0, "Invert Word B");
     configParam(RATE_ATTEN_PARAM, -1.f, 1.f, 0.f, "Clock Rate Attenuverter");
+    auto patternParamQuantity = configParam(PATTERN_PARAM, 0.f, PatternMemory::NUM_PATTERNS, 0.f, "Pattern");
+    patternParamQuantity->snapEnabled = true;
+    patternParamQuantity->description = "0 plays the panel switches";
     
-    wordA_switches = 0;
-    wordB_switches = 0;
     for (int i = 0; i < 16; i++) {
         configSwitch(BIT_A_PARAMS + i, 0, 1, 0, string::f("Word A Bit %d", i + 1));
-        if (params[BIT_A_PARAMS + i].getValue() > 0.5f) wordA_switches |= (1 << i);
         configSwitch(BIT_B_PARAMS + i, 0, 1, 0, string::f("Word B Bit %d", i + 1));
-        if (params[BIT_B_PARAMS + i].getValue() > 0.5f) wordB_switches |= (1 << i);
     }
     
     configInput(CLOCK_INPUT, "Clock");
@@ -39,6 +41,8 @@ WordGenerator::WordGenerator() {
     configInput(WORD_LENGTH_CV_INPUT, "Word Length CV");
     configInput(MODE_FLIP_TRIGGER_INPUT, "Flip 16/32 Mode Trigger");
     configInput(RATE_CV_INPUT, "Clock Rate CV");
+    configInput(PATTERN_CV_INPUT, "Pattern Select CV");
+    configInput(DATA_INPUT, "BERT Data");
     
     configOutput(WORD_A_GATE_OUTPUT, "Word A Gate");
     configOutput(WORD_B_GATE_OUTPUT, "Word B Gate");
@@ -47,207 +51,740 @@ WordGenerator::WordGenerator() {
     configOutput(FIRST_BIT_OUTPUT, "First Bit");
     configOutput(LAST_BIT_OUTPUT, "Last Bit");
     configOutput(CLOCK_OUTPUT, "Clock");
+    configOutput(WORD_A_PARALLEL_OUTPUT, "Word A Parallel (16 channels, bit n on channel n)");
+    configOutput(WORD_B_PARALLEL_OUTPUT, "Word B Parallel (16 channels, bit n on channel n)");
+    configOutput(WORD_A_DAC_OUTPUT, "Word A DAC");
+    configOutput(WORD_B_DAC_OUTPUT, "Word B DAC");
+    configOutput(ERROR_OUTPUT, "BERT Word Error");
+    configOutput(ERROR_RATE_OUTPUT, "BERT Error Rate (1 V/decade)");
+    configOutput(CLOCK_X2_OUTPUT, "Clock x2");
+    configOutput(CLOCK_DIV2_OUTPUT, "Clock /2");
+    configOutput(CLOCK_DIV4_OUTPUT, "Clock /4");
+    configOutput(WORD_CLOCK_OUTPUT, "Word Clock");
     
-    prnState = rack::random::u32(); if (prnState == 0) prnState = 0xabcdef12;
-    currentPrnPatternA = prnState & 0xFFFF; currentPrnPatternB = (prnState >> 16) & 0xFFFF;
-    stepFinalWordA = wordA_switches;
-    stepFinalWordB = wordB_switches;
+    for (int g = 0; g < NUM_GROUPS; g++) {
+        scheduledRates[g] = 0.f;
+        wordAGatePulses[g] = 0.f; wordBGatePulses[g] = 0.f;
+        firstBitPulses[g] = 0.f; lastBitPulses[g] = 0.f;
+        errorPulses[g] = 0.f;
+    }
+    rightExpander.producerMessage = &bankMessages[0];
+    rightExpander.consumerMessage = &bankMessages[1];
+    kernel = selectKernel(false, false);
+    controlDivider.setDivision(CONTROL_DIVISION);
+    lightDivider.setDivision(LIGHT_DIVISION);
+    sharedConfig = readConfig();
+    for (int c = 0; c < MAX_CHANNELS; c++) {
+        channelConfigs[c] = sharedConfig;
+        lastTickFrames[c] = INT64_MIN / 2;
+        engines[c].reset(sharedConfig, resetSeed(c));
+    }
 }
 
-void WordGenerator::process(const ProcessArgs& args) {
-    int runMode = std::round(params[RUN_MODE_PARAM].getValue());
-    int wordLength;
+WordGenerator::~WordGenerator() {
+    delete stream;
+    delete pendingStream.exchange(nullptr);
+    delete retiredStream.exchange(nullptr);
+}
+
+// Controls shared by all channels. Word length and PRN probability are knob values here,
+// their CV inputs are applied per channel by readChannelConfig().
+WordEngine::Config WordGenerator::readConfig() {
+    WordEngine::Config config;
     int wordLengthParamValue = (int)std::round(params[WORD_LENGTH_PARAM].getValue());
+    config.wordLength = std::max(1, wordLengthParamValue);
+    config.is16BitMode = params[MODE_PARAM].getValue() < 0.5f;
+    config.singleRunMode = std::round(params[RUN_MODE_PARAM].getValue()) == 1;
+    config.invertA = params[INVERT_A_PARAM].getValue() > 0.5f;
+    config.invertB = params[INVERT_B_PARAM].getValue() > 0.5f;
+
+    readSwitches(wordA_switches, wordB_switches);
+    config.wordA_switches[0] = wordA_switches;
+    config.wordB_switches[0] = wordB_switches;
+
+    // Further banks from the expanders chained to the right
+    expanders = 0;
+    for (Module* m = rightExpander.module; m && m->model == modelWordExpander && expanders < MAX_EXPANDERS; m = m->rightExpander.module) {
+        expanders++;
+    }
+    const WordBankMessage* bankMessage = static_cast<const WordBankMessage*>(rightExpander.consumerMessage);
+    for (int k = 0; k < expanders; k++) {
+        config.wordA_switches[k + 1] = bankMessage->wordA_switches[k];
+        config.wordB_switches[k + 1] = bankMessage->wordB_switches[k];
+    }
+    config.banks = 1 + expanders;
+
+    if (stream && stream->isOpen()) {
+        config.streamWords = stream->words();
+        config.streamTicks = stream->ticks();
+    }
+
+    config.prnProbability = params[PRN_PROB_PARAM].getValue();
+    return config;
+}
+
+// The panel's bit switches as two words, switch i in bit i
+void WordGenerator::readSwitches(uint16_t& wordA, uint16_t& wordB) {
+    wordA = 0;
+    wordB = 0;
+    for (int i = 0; i < 16; i++) {
+        if (params[BIT_A_PARAMS + i].getValue() > 0.5f) wordA |= (1 << i);
+        if (params[BIT_B_PARAMS + i].getValue() > 0.5f) wordB |= (1 << i);
+    }
+}
+
+WordEngine::Config WordGenerator::readChannelConfig(const WordEngine::Config& shared, int channel) {
+    WordEngine::Config config = shared;
+    if (activePatterns[channel] > 0) patternMemory.apply(activePatterns[channel] - 1, config);
     if (inputs[WORD_LENGTH_CV_INPUT].isConnected()) {
-        float cvValue = inputs[WORD_LENGTH_CV_INPUT].getVoltage();
+        float cvValue = inputs[WORD_LENGTH_CV_INPUT].getPolyVoltage(channel);
         int cvSteps = static_cast<int>(std::round(cvValue * 1.5f));
-        wordLength = std::max(1, std::min(16, wordLengthParamValue + cvSteps));
-    } else {
-        wordLength = wordLengthParamValue;
+        config.wordLength = std::max(1, std::min(16, config.wordLength + cvSteps));
     }
-    wordLength = std::max(1, wordLength);
+    float prnProbCv = inputs[PRN_PROBABILITY_INPUT].isConnected() ? (inputs[PRN_PROBABILITY_INPUT].getPolyVoltage(channel) / 10.f) : 0.f;
+    config.prnProbability = clamp(shared.prnProbability + prnProbCv, 0.f, 1.f);
+    return config;
+}
 
-    int clockMode = std::round(params[CLOCK_MODE_PARAM].getValue());
-    if (modeFlipTrigger.process(inputs[MODE_FLIP_TRIGGER_INPUT].getVoltage())) {
-        params[MODE_PARAM].setValue(1.0f - params[MODE_PARAM].getValue());
+// Re-reads the params and per-channel CVs. Only changes to what selects the current output
+// bits (length, mode, inversion) mark the outputs dirty; the rest is first used at the next tick.
+void WordGenerator::refreshControls() {
+    sharedConfig = readConfig();
+    float patternKnob = params[PATTERN_PARAM].getValue();
+    for (int c = 0; c < channels; c++) {
+        float patternCv = inputs[PATTERN_CV_INPUT].isConnected() ? inputs[PATTERN_CV_INPUT].getPolyVoltage(c) * PATTERN_CV_SCALE : 0.f;
+        requestedPatterns[c] = clamp((int)std::round(patternKnob + patternCv), 0, PatternMemory::NUM_PATTERNS);
+        WordEngine::Config channelConfig = readChannelConfig(sharedConfig, c);
+        const WordEngine::Config& previous = channelConfigs[c];
+        if (channelConfig.wordLength != previous.wordLength || channelConfig.is16BitMode != previous.is16BitMode
+            || channelConfig.banks != previous.banks || channelConfig.invertA != previous.invertA || channelConfig.invertB != previous.invertB) {
+            controlsDirty = true;
+        }
+        channelConfigs[c] = channelConfig;
+    }
+}
+
+uint64_t WordGenerator::resetSeed(int channel) {
+    return seeded ? seed + channel : rack::random::u64();
+}
+
+// Takes up the requested pattern. Callers only do so on a word boundary.
+void WordGenerator::latchPattern(int channel) {
+    activePatterns[channel] = requestedPatterns[channel];
+}
+
+void WordGenerator::updateLights() {
+    updateExpanderDisplays();
+    // Lights follow channel 1
+    const WordEngine::Config& config = channelConfigs[0];
+    uint16_t displayWordA = engines[0].displayWordA(config);
+    uint16_t displayWordB = engines[0].displayWordB(config);
+    if (displayWordA == shownWordA && displayWordB == shownWordB && config.wordLength == shownWordLength) return;
+    shownWordA = displayWordA; shownWordB = displayWordB; shownWordLength = config.wordLength;
+    for (int i = 0; i < 16; ++i) {
+        if (i >= config.wordLength) { lights[BIT_A_LIGHTS + i].setBrightness(0.1f); lights[BIT_B_LIGHTS + i].setBrightness(0.1f); }
+        else { lights[BIT_A_LIGHTS + i].setBrightness((displayWordA & (1 << i)) ? 1.f : 0.f); lights[BIT_B_LIGHTS + i].setBrightness((displayWordB & (1 << i)) ? 1.f : 0.f); }
+    }
+}
+
+// Writes each expander's bank lights straight into its left message, following channel 1
+void WordGenerator::updateExpanderDisplays() {
+    const WordEngine::Config& config = channelConfigs[0];
+    int activeBank = WordEngine::stepBank(config, engines[0].currentStep);
+    Module* m = rightExpander.module;
+    for (int k = 0; k < expanders && m && m->model == modelWordExpander; k++, m = m->rightExpander.module) {
+        WordDisplayMessage* message = static_cast<WordDisplayMessage*>(m->leftExpander.producerMessage);
+        message->connected = true;
+        message->displayWordA = engines[0].displayWordA(config, k + 1);
+        message->displayWordB = engines[0].displayWordB(config, k + 1);
+        message->wordLength = config.wordLength;
+        message->active = activeBank == k + 1;
+        m->leftExpander.requestMessageFlip();
+    }
+}
+
+// dsp::PulseGenerator::process() on four lanes: high while time remains, then counts down
+static inline simd::float_4 processPulses(simd::float_4& remaining, float sampleTime) {
+    simd::float_4 active = remaining > 0.f;
+    remaining -= simd::ifelse(active, sampleTime, 0.f);
+    return simd::ifelse(active, 10.f, 0.f);
+}
+
+static inline void triggerPulse(simd::float_4& remaining, int lane) {
+    float duration = WordEngine::PULSE_DURATION; // By value: std::max would odr-use the constexpr member
+    remaining[lane] = std::max(remaining[lane], duration);
+}
+
+static inline void insertDiscontinuity(dsp::MinBlepGenerator<16, 16, simd::float_4>& blep, int lane, float offset, float jump) {
+    simd::float_4 x = 0.f;
+    x[lane] = jump;
+    blep.insertDiscontinuity(offset, x);
+}
+
+json_t* WordGenerator::dataToJson() {
+    json_t* rootJ = json_object();
+    json_object_set_new(rootJ, "audioRate", json_boolean(audioRate));
+    json_object_set_new(rootJ, "patterns", json_string(patternMemory.toHex().c_str()));
+    json_object_set_new(rootJ, "saveStats", json_boolean(saveStats));
+    if (saveStats) json_object_set_new(rootJ, "stats", statsToJson());
+    json_object_set_new(rootJ, "seeded", json_boolean(seeded));
+    json_object_set_new(rootJ, "seed", json_string(std::to_string(seed).c_str())); // Full 64 bits, beyond json_int_t
+    if (!streamPath.empty()) json_object_set_new(rootJ, "bitstreamPath", json_string(streamPath.c_str()));
+    return rootJ;
+}
+
+void WordGenerator::dataFromJson(json_t* rootJ) {
+    json_t* audioRateJ = json_object_get(rootJ, "audioRate");
+    if (audioRateJ) setAudioRate(json_boolean_value(audioRateJ));
+    json_t* patternsJ = json_object_get(rootJ, "patterns");
+    if (patternsJ) patternMemory.fromHex(json_string_value(patternsJ) ? json_string_value(patternsJ) : "");
+    json_t* saveStatsJ = json_object_get(rootJ, "saveStats");
+    if (saveStatsJ) saveStats = json_boolean_value(saveStatsJ);
+    json_t* seededJ = json_object_get(rootJ, "seeded");
+    if (seededJ) seeded = json_boolean_value(seededJ);
+    json_t* seedJ = json_object_get(rootJ, "seed");
+    if (seedJ && json_string_value(seedJ)) seed = std::strtoull(json_string_value(seedJ), nullptr, 10);
+    json_t* bitstreamPathJ = json_object_get(rootJ, "bitstreamPath");
+    if (bitstreamPathJ && json_string_value(bitstreamPathJ) && !loadStream(json_string_value(bitstreamPathJ))) {
+        WARN("Word Generator: could not map bitstream %s", json_string_value(bitstreamPathJ));
+    }
+    // The engines were reset with random seeds on construction; restart them from the saved one
+    if (seeded) {
+        for (int c = 0; c < MAX_CHANNELS; c++) engines[c].reset(channelConfigs[c], resetSeed(c));
     }
-    bool is16BitMode = params[MODE_PARAM].getValue() < 0.5f;
+    controlsDirty = true;
+}
+
+// Snapshot of the counters, written on save for offline comparison of instances. Never read back.
+json_t* WordGenerator::statsToJson() {
+    json_t* statsJ = json_object();
+    json_object_set_new(statsJ, "settings", json_string(settingsSummary().c_str()));
+    json_object_set_new(statsJ, "ticks", json_integer(stats.ticks.get()));
+    json_object_set_new(statsJ, "ticksPerSecond", json_real(stats.ticksPerSecond.load(std::memory_order_relaxed)));
+    json_object_set_new(statsJ, "prnDraws", json_integer(stats.prnDraws.get()));
+    json_object_set_new(statsJ, "singleCycles", json_integer(stats.singleCycles.get()));
+    json_object_set_new(statsJ, "missedEdges", json_integer(stats.missedEdges.get()));
+    json_object_set_new(statsJ, "mergedEdges", json_integer(stats.mergedEdges.get()));
+    json_object_set_new(statsJ, "processCalls", json_integer(stats.processCalls.get()));
+    json_object_set_new(statsJ, "nanosecondsPerCall", json_real(stats.nanosecondsPerCall()));
+    json_object_set_new(statsJ, "bitsCompared", json_integer(stats.bitsCompared.get()));
+    json_object_set_new(statsJ, "bitErrors", json_integer(stats.bitErrors.get()));
+    return statsJ;
+}
+
+// The settings that drive the per-sample cost
+std::string WordGenerator::settingsSummary() {
+    const WordEngine::Config& config = channelConfigs[0];
+    bool external = lastClockMode == 1;
+    return string::f("%d ch, %s clock%s, %d bank%s, PRN %.2f", channels, external ? "ext." : "int.",
+        (!external && audioRate) ? " (audio rate)" : "", config.banks, config.banks == 1 ? "" : "s", config.prnProbability);
+}
+
+int WordGenerator::selectedPattern() {
+    return clamp((int)std::round(params[PATTERN_PARAM].getValue()), 0, PatternMemory::NUM_PATTERNS);
+}
+
+// Pattern memory edits from the menu (patterns 1-based). UI thread: they are queued for the next
+// process(), which applies them, so the pattern memory is only ever written by the audio thread.
+void WordGenerator::storePattern(int pattern) {
+    if (pattern < 1) return;
+    patternRequest.store(PATTERN_STORE | (pattern - 1), std::memory_order_release);
+}
+
+void WordGenerator::clearPattern(int pattern) {
+    if (pattern < 1) return;
+    patternRequest.store(PATTERN_CLEAR | (pattern - 1), std::memory_order_release);
+}
+
+void WordGenerator::clearAllPatterns() {
+    patternRequest.store(PATTERN_CLEAR_ALL, std::memory_order_release);
+}
+
+// Audio thread. A store takes the panel switches, knob length and mode switch.
+void WordGenerator::applyPatternRequest(uint32_t request) {
+    int index = request & PATTERN_INDEX_MASK;
+    switch (request & ~PATTERN_INDEX_MASK) {
+        case PATTERN_STORE: {
+            WordEngine::Config config;
+            config.wordLength = std::max(1, (int)std::round(params[WORD_LENGTH_PARAM].getValue()));
+            config.is16BitMode = params[MODE_PARAM].getValue() < 0.5f;
+            readSwitches(config.wordA_switches[0], config.wordB_switches[0]);
+            patternMemory.store(index, config);
+            break;
+        }
+        case PATTERN_CLEAR: patternMemory.clear(index); break;
+        case PATTERN_CLEAR_ALL: patternMemory.clearAll(); break;
+    }
+}
+
+// Every channel jumps to the tick at the next sample, as if reset with its seed and clocked `tick` times
+void WordGenerator::requestSeek(uint64_t tick) {
+    seekRequest.store(SEEK_PENDING | (tick & ~SEEK_PENDING), std::memory_order_release);
+}
+
+// Maps a bitstream file and queues it for playback, which starts from its first bit at the next
+// sample. UI thread. Returns false, leaving the current playback alone, if the file can't be mapped.
+bool WordGenerator::loadStream(const std::string& path) {
+    BitstreamFile* file = new BitstreamFile;
+    if (!file->open(path)) { delete file; return false; }
+    delete pendingStream.exchange(file, std::memory_order_acq_rel); // Never seen by the audio thread
+    streamPath = path;
+    collectRetiredStream();
+    return true;
+}
 
-    uint16_t current_wordA_switches = 0;
-    uint16_t current_wordB_switches = 0;
+void WordGenerator::unloadStream() {
+    delete pendingStream.exchange(new BitstreamFile, std::memory_order_acq_rel);
+    streamPath.clear();
+    collectRetiredStream();
+}
+
+// Unmaps the file the audio thread last swapped out. UI thread.
+void WordGenerator::collectRetiredStream() {
+    if (retiredStream.load(std::memory_order_relaxed)) delete retiredStream.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+// Audio thread. Playback restarts from the top, as a seek to tick 0.
+void WordGenerator::swapStream() {
+    BitstreamFile* previous = stream;
+    stream = pendingStream.exchange(nullptr, std::memory_order_acq_rel);
+    // Only if the UI thread hasn't collected the last one yet, which takes two swaps within a frame
+    delete retiredStream.exchange(previous, std::memory_order_acq_rel);
+    requestSeek(0);
+}
+
+// Copies a stored pattern onto the panel for editing
+void WordGenerator::loadPattern(int pattern) {
+    if (pattern < 1 || !patternMemory.isStored(pattern - 1)) return;
+    const WordPattern& stored = patternMemory.patterns[pattern - 1];
     for (int i = 0; i < 16; i++) {
-        if (params[BIT_A_PARAMS + i].getValue() > 0.5f) current_wordA_switches |= (1 << i);
-        if (params[BIT_B_PARAMS + i].getValue() > 0.5f) current_wordB_switches |= (1 << i);
+        params[BIT_A_PARAMS + i].setValue((stored.wordA >> i) & 1);
+        params[BIT_B_PARAMS + i].setValue((stored.wordB >> i) & 1);
+    }
+    params[WORD_LENGTH_PARAM].setValue(stored.wordLength);
+    params[MODE_PARAM].setValue((stored.flags & WordPattern::MODE_32_BIT) ? 1.f : 0.f);
+}
+
+void WordGenerator::setAudioRate(bool enabled) {
+    audioRate = enabled;
+    // Keep the knob's displayed frequency truthful
+    paramQuantities[CLOCK_RATE_PARAM]->displayMultiplier = enabled ? std::pow(2.f, AUDIO_RATE_OCTAVES) : 1.f;
+}
+
+void WordGenerator::process(const ProcessArgs& args) {
+    if (stats.clearRequested.load(std::memory_order_relaxed)) {
+        stats.clear();
+        statsWindowFrames = 0;
+        statsWindowTicks = 0;
+        stats.clearRequested.store(false, std::memory_order_relaxed);
     }
-    wordA_switches = current_wordA_switches;
-    wordB_switches = current_wordB_switches;
+    if (++statsWindowFrames >= args.sampleRate) updateStatsWindow(args.sampleRate);
+
+    // Time one call in PROFILE_INTERVAL, so that the clock reads stay off the per-sample cost
+    if (++profileCounter < PROFILE_INTERVAL) {
+        processFrame(args);
+        return;
+    }
+    profileCounter = 0;
+    auto start = std::chrono::steady_clock::now();
+    processFrame(args);
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    stats.processCalls.add(PROFILE_INTERVAL);
+    stats.profiledCalls.add(1);
+    stats.profiledNanoseconds.add(elapsed.count());
+}
 
-    // Triggers & State Management (Invert, Reset, Single Cycle)
+void WordGenerator::updateStatsWindow(float sampleRate) {
+    uint64_t ticks = stats.ticks.get();
+    stats.ticksPerSecond.store((ticks - statsWindowTicks) * sampleRate / statsWindowFrames, std::memory_order_relaxed);
+    statsWindowTicks = ticks;
+    statsWindowFrames = 0;
+}
+
+void WordGenerator::processFrame(const ProcessArgs& args) {
+    int clockMode = std::round(params[CLOCK_MODE_PARAM].getValue());
+
+    // Triggers & State Management (Mode/Invert flips, Reset, Single Cycle)
+    bool controlChanged = false;
+    if (modeFlipTrigger.process(inputs[MODE_FLIP_TRIGGER_INPUT].getVoltage())) {
+        params[MODE_PARAM].setValue(1.0f - params[MODE_PARAM].getValue());
+        controlChanged = true;
+    }
     if (invertAFlipTrigger.process(inputs[INVERT_A_FLIP_TRIGGER_INPUT].getVoltage())) {
         params[INVERT_A_PARAM].setValue(1.0f - params[INVERT_A_PARAM].getValue());
+        controlChanged = true;
     }
     if (invertBFlipTrigger.process(inputs[INVERT_B_FLIP_TRIGGER_INPUT].getVoltage())) {
         params[INVERT_B_PARAM].setValue(1.0f - params[INVERT_B_PARAM].getValue());
+        controlChanged = true;
     }
-    bool resetPressed = resetTrigger.process(inputs[RESET_INPUT].getVoltage());
     bool singleCycleBtnPressed = singleCycleButtonTrigger.process(params[SINGLE_CYCLE_BUTTON_PARAM].getValue());
     bool manualExtGate = manualExtTrigger.process(inputs[MANUAL_TRIGGER_INPUT].getVoltage());
+    bool singleCycleStart = singleCycleBtnPressed || manualExtGate;
+    if (pendingStream.load(std::memory_order_relaxed)) {
+        swapStream();
+        controlChanged = true;
+    }
+    // The exchange is a locked write, so it is only paid when a request is waiting
+    bool seek = false;
+    if (seekRequest.load(std::memory_order_relaxed)) {
+        uint64_t request = seekRequest.exchange(0, std::memory_order_acquire);
+        seek = request & SEEK_PENDING;
+        if (seek) seekTick = request & ~SEEK_PENDING;
+    }
+    if (patternRequest.load(std::memory_order_relaxed)) {
+        applyPatternRequest(patternRequest.exchange(0, std::memory_order_acquire));
+        controlsDirty = true;
+        controlChanged = true;
+    }
 
-    if (resetPressed) {
-        currentStep = 0; clockPhase = 0.f; forceSingleCycle = false; singleCycleComplete = false;
-        prnState = rack::random::u32(); if (prnState == 0) prnState = 0xabcdef12;
-        currentPrnPatternA = prnState & 0xFFFF; currentPrnPatternB = (prnState >> 16) & 0xFFFF;
-        stepFinalWordA = wordA_switches; stepFinalWordB = wordB_switches;
-    }
-    if (singleCycleBtnPressed || manualExtGate) {
-        currentStep = 0; forceSingleCycle = true; singleCycleComplete = false;
-        if (clockMode == 1) { // EXTERNAL: immediate first step processing
-            prnState = generatePRN(prnState);
-            currentPrnPatternA = prnState & 0xFFFF; currentPrnPatternB = (prnState >> 16) & 0xFFFF;
-            float prnProbKnobValue = params[PRN_PROB_PARAM].getValue();
-            float prnProbCv = inputs[PRN_PROBABILITY_INPUT].isConnected() ? (inputs[PRN_PROBABILITY_INPUT].getVoltage() / 10.f) : 0.f;
-            float finalPrnProbability = clamp(prnProbKnobValue + prnProbCv, 0.f, 1.f);
-            uint16_t firstStepWordA_imm = 0; uint16_t firstStepWordB_imm = 0;
-            for (int i = 0; i < 16; ++i) {
-                if (random::uniform() < finalPrnProbability) { if (currentPrnPatternA & (1 << i)) firstStepWordA_imm |= (1 << i); }
-                else { if (wordA_switches & (1 << i)) firstStepWordA_imm |= (1 << i); }
-                if (random::uniform() < finalPrnProbability) { if (currentPrnPatternB & (1 << i)) firstStepWordB_imm |= (1 << i); }
-                else { if (wordB_switches & (1 << i)) firstStepWordB_imm |= (1 << i); }
+    int newChannels = std::max({1, inputs[CLOCK_INPUT].getChannels(), inputs[RESET_INPUT].getChannels(),
+        inputs[WORD_LENGTH_CV_INPUT].getChannels(), inputs[PRN_PROBABILITY_INPUT].getChannels(), inputs[RATE_CV_INPUT].getChannels(),
+        inputs[PATTERN_CV_INPUT].getChannels(), inputs[DATA_INPUT].getChannels()});
+    if (newChannels != channels || clockMode != lastClockMode || audioRate != lastAudioRate) {
+        // New channels' word, DAC and parallel outputs are set up now rather than at their first tick
+        if (newChannels != channels) controlsDirty = true;
+        channels = newChannels;
+        lastClockMode = clockMode;
+        lastAudioRate = audioRate;
+        kernel = selectKernel(clockMode == 1, audioRate);
+        clockScheduleValid = false;
+        controlChanged = true;
+    }
+    if (controlDivider.process() || controlChanged) {
+        refreshControls();
+    }
+
+    (this->*kernel)(args, singleCycleStart, seek);
+}
+
+// Kernels, one per clock source and audio-rate setting. The per-sample branches on those settings
+// are resolved at compile time; word width and inversion are already folded into each engine's
+// output schedule, and probability 0 skips the PRN mixing in WordEngine::nextStepWords().
+WordGenerator::Kernel WordGenerator::selectKernel(bool externalClock, bool audioRate) {
+    static const Kernel kernels[2][2] = {
+        {&WordGenerator::processKernel<false, false>, &WordGenerator::processKernel<false, true>},
+        {&WordGenerator::processKernel<true, false>, &WordGenerator::processKernel<true, false>}, // Audio rate only applies to the internal clock
+    };
+    return kernels[externalClock][audioRate];
+}
+
+template <bool EXTERNAL_CLOCK, bool AUDIO_RATE>
+void WordGenerator::processKernel(const ProcessArgs& args, bool singleCycleStart, bool seek) {
+
+    int resetLanes[NUM_GROUPS];
+    bool anyReset = false;
+    for (int c = 0; c < channels; c += 4) {
+        resetLanes[c / 4] = simd::movemask(resetTriggers[c / 4].process(inputs[RESET_INPUT].getPolyVoltageSimd<simd::float_4>(c)));
+        anyReset |= resetLanes[c / 4] != 0;
+    }
+
+    // Internal clock rate in log2 Hz, compared against the rate each channel was scheduled for
+    float clockRateValue = params[CLOCK_RATE_PARAM].getValue();
+    float attenuverterValue = params[RATE_ATTEN_PARAM].getValue();
+    float minClockRate = log2f(0.1f);
+    float maxClockRate = log2f(1000.f);
+    if (AUDIO_RATE) {
+        clockRateValue += AUDIO_RATE_OCTAVES;
+        minClockRate += AUDIO_RATE_OCTAVES;
+        maxClockRate = log2f(args.sampleRate * MAX_AUDIO_RATE_FRACTION);
+    }
+    simd::float_4 clockRates[NUM_GROUPS];
+    int rateChangedLanes[NUM_GROUPS] = {};
+    bool anyRateChanged = false;
+    if (!EXTERNAL_CLOCK) {
+        for (int c = 0; c < channels; c += 4) {
+            simd::float_4 modulatedClockRate = clockRateValue;
+            if (inputs[RATE_CV_INPUT].isConnected()) {
+                simd::float_4 cvVoltage = inputs[RATE_CV_INPUT].getPolyVoltageSimd<simd::float_4>(c);
+                modulatedClockRate += (cvVoltage / 5.0f) * attenuverterValue;
             }
-            stepFinalWordA = firstStepWordA_imm; stepFinalWordB = firstStepWordB_imm;
-            firstBitPulse.trigger(0.001f);
-            int effectiveSeqLen = is16BitMode ? wordLength : (wordLength * 2);
-            if (0 == effectiveSeqLen - 1) { lastBitPulse.trigger(0.001f); singleCycleComplete = true; }
+            // Clamp the modulated rate to the knob's log range
+            clockRates[c / 4] = simd::clamp(modulatedClockRate, minClockRate, maxClockRate);
+            rateChangedLanes[c / 4] = clockScheduleValid ? simd::movemask(simd::fabs(clockRates[c / 4] - scheduledRates[c / 4]) > RATE_RESCHEDULE_THRESHOLD) : 0xF;
+            anyRateChanged |= rateChangedLanes[c / 4] != 0;
         }
     }
 
-    if (forceSingleCycle) { isRunning = !singleCycleComplete; if(singleCycleComplete) forceSingleCycle = false; }
-    else { isRunning = (runMode == 0); }
-    
-    bool clockTick = false;
-    if (clockMode == 0) { // Internal Clock
-        float clockRateValue = params[CLOCK_RATE_PARAM].getValue();
-        float modulatedClockRate = clockRateValue;
-        if (inputs[RATE_CV_INPUT].isConnected()) {
-            float cvVoltage = inputs[RATE_CV_INPUT].getVoltage();
-            float attenuverterValue = params[RATE_ATTEN_PARAM].getValue();
-            modulatedClockRate += (cvVoltage / 5.0f) * attenuverterValue;
+    // Fast path: between scheduled clock events only the pulse timers move, every other output holds
+    if (!EXTERNAL_CLOCK && quietSamples > 0 && !controlsDirty && !singleCycleStart && !seek && !anyReset && !anyRateChanged) {
+        quietSamples--;
+        skippedSamples++;
+        for (int c = 0; c < channels; c += 4) {
+            if (AUDIO_RATE) processCvOutputs<AUDIO_RATE>(c); // minBLEP tails still ringing out
+            processPulseOutputs(c, args.sampleTime);
         }
-        // Clamp the modulated rate to the original knob's log range
-        modulatedClockRate = clamp(modulatedClockRate, log2f(0.1f), log2f(1000.f));
-        float clockFreq = powf(2.f, modulatedClockRate);
-        clockPhase += clockFreq * args.sampleTime;
-        if (clockPhase >= 1.f) { clockTick = true; clockPhase -= floorf(clockPhase); }
-        clockInputState = clockPhase < 0.5f;
-        outputs[CLOCK_OUTPUT].setVoltage(clockInputState ? 10.f : 0.f);
-    } else { // External Clock
-        if (clockTrigger.process(inputs[CLOCK_INPUT].getVoltage())) { clockTick = true; }
-        clockInputState = inputs[CLOCK_INPUT].getVoltage() >= 1.f;
-        outputs[CLOCK_OUTPUT].setVoltage(inputs[CLOCK_INPUT].getVoltage());
+        if (lightDivider.process()) updateLights();
+        return;
     }
-    
-    if (clockTick && isRunning) {
-        prnState = generatePRN(prnState);
-        currentPrnPatternA = prnState & 0xFFFF; currentPrnPatternB = (prnState >> 16) & 0xFFFF;
-        float prnProbKnobValue = params[PRN_PROB_PARAM].getValue();
-        float prnProbCv = inputs[PRN_PROBABILITY_INPUT].isConnected() ? (inputs[PRN_PROBABILITY_INPUT].getVoltage() / 10.f) : 0.f;
-        float finalPrnProbability = clamp(prnProbKnobValue + prnProbCv, 0.f, 1.f);
-        uint16_t nextStepWordA = 0; uint16_t nextStepWordB = 0;
-        for (int i = 0; i < 16; ++i) {
-            if (random::uniform() < finalPrnProbability) { if (currentPrnPatternA & (1 << i)) nextStepWordA |= (1 << i); }
-            else { if (wordA_switches & (1 << i)) nextStepWordA |= (1 << i); }
-            if (random::uniform() < finalPrnProbability) { if (currentPrnPatternB & (1 << i)) nextStepWordB |= (1 << i); }
-            else { if (wordB_switches & (1 << i)) nextStepWordB |= (1 << i); }
+
+    for (int o = 0; o < NUM_OUTPUTS; o++) {
+        outputs[o].setChannels((o == WORD_A_PARALLEL_OUTPUT || o == WORD_B_PARALLEL_OUTPUT) ? 16 : channels);
+    }
+    int samplesToEvent = INT_MAX;
+    int ticked = 0, prnDrawn = 0, completed = 0, missed = 0, merged = 0; // Published to stats below
+    int comparedBits = 0, bitErrors = 0;
+    bool bertEnabled = inputs[DATA_INPUT].isConnected();
+    bool derivedClocks = outputs[CLOCK_X2_OUTPUT].isConnected() || outputs[CLOCK_DIV2_OUTPUT].isConnected()
+        || outputs[CLOCK_DIV4_OUTPUT].isConnected() || outputs[WORD_CLOCK_OUTPUT].isConnected();
+    if (bertEnabled != bertActive) {
+        // Each patching of the data input starts a fresh session, searching for sync; unpatched reads 0 V
+        bertActive = bertEnabled;
+        for (int c = 0; c < MAX_CHANNELS; c++) { testers[c].restart(); errorRates[c] = bertEnabled ? 10.f : 0.f; }
+        for (int c = 0; c < channels; c += 4) outputs[ERROR_RATE_OUTPUT].setVoltageSimd(simd::float_4::load(&errorRates[c]), c);
+        stats.bertDelay.store(-1, std::memory_order_relaxed);
+    }
+
+    for (int c = 0; c < channels; c += 4) {
+        int g = c / 4;
+        int tickLanes = 0;
+        int wordLanes = 0; // Lanes whose parallel words may have moved
+        int testedLanes = 0; // Lanes whose BERT finished a word
+        if (EXTERNAL_CLOCK) { // External Clock
+            simd::float_4 clockVoltage = inputs[CLOCK_INPUT].getPolyVoltageSimd<simd::float_4>(c);
+            tickLanes = simd::movemask(clockTriggers[g].process(clockVoltage));
+            clockVoltage.store(&clockCvs[c]);
         }
-        stepFinalWordA = nextStepWordA; stepFinalWordB = nextStepWordB;
-
-        // Determine bit states for the current step to trigger gates
-        bool triggerGateA = false;
-        bool triggerGateB = false;
-        int stepInSegmentForGateTrig;
-        bool currentEffectiveInvertA_forGate = params[INVERT_A_PARAM].getValue() > 0.5f;
-        bool currentEffectiveInvertB_forGate = params[INVERT_B_PARAM].getValue() > 0.5f;
-        uint16_t displayWordA_forGate = currentEffectiveInvertA_forGate ? (~stepFinalWordA & 0xFFFF) : stepFinalWordA;
-        uint16_t displayWordB_forGate = currentEffectiveInvertB_forGate ? (~stepFinalWordB & 0xFFFF) : stepFinalWordB;
-
-        if (is16BitMode) {
-            stepInSegmentForGateTrig = currentStep % wordLength;
-            if (stepInSegmentForGateTrig < wordLength) {
-                triggerGateA = (displayWordA_forGate & (1 << stepInSegmentForGateTrig)) != 0;
-                triggerGateB = (displayWordB_forGate & (1 << stepInSegmentForGateTrig)) != 0;
+
+        // Sequencing stays scalar per channel; the common case is neither reset nor tick
+        for (int lane = 0; lane < 4 && c + lane < channels; lane++) {
+            int channel = c + lane;
+            WordEngine& engine = engines[channel];
+            WordEngine::Config& channelConfig = channelConfigs[channel];
+            bool bitsChanged = controlsDirty;
+
+            if (!EXTERNAL_CLOCK && skippedSamples > 0) {
+                engine.advanceScheduledClock(skippedSamples); // Event free by construction
+            }
+            if (resetLanes[g] & (1 << lane)) {
+                latchPattern(channel);
+                channelConfig = readChannelConfig(sharedConfig, channel);
+                engine.reset(channelConfig, resetSeed(channel));
+                restartTester(channel);
+                testedLanes |= 1 << lane;
+                bitsChanged = true;
+            }
+            if (seek) {
+                latchPattern(channel);
+                channelConfig = readChannelConfig(sharedConfig, channel);
+                engine.seek(channelConfig, seekTick);
+                restartTester(channel);
+                testedLanes |= 1 << lane;
+                bitsChanged = true;
+            }
+            int events = 0;
+            if (singleCycleStart) {
+                latchPattern(channel);
+                channelConfig = readChannelConfig(sharedConfig, channel);
+                events |= engine.beginSingleCycle(channelConfig, EXTERNAL_CLOCK); // EXTERNAL: immediate first step processing
+                bitsChanged = true;
+            }
+            engine.updateRunState(channelConfig);
+            if (!EXTERNAL_CLOCK) { // Internal Clock
+                if (rateChangedLanes[g] & (1 << lane)) {
+                    scheduledRates[g][lane] = clockRates[g][lane];
+                    engine.scheduleClock(powf(2.f, clockRates[g][lane]), args.sampleTime);
+                }
+                if (engine.advanceScheduledClock(1)) tickLanes |= 1 << lane;
+                float clockCv = engine.scheduledClockHigh() ? 10.f : 0.f;
+                if (AUDIO_RATE && clockCv != clockCvs[channel]) {
+                    float offset = (tickLanes & (1 << lane)) ? engine.tickOffset() : engine.fallOffset();
+                    insertDiscontinuity(clockBleps[g], lane, offset, clockCv - clockCvs[channel]);
+                }
+                clockCvs[channel] = clockCv;
+                samplesToEvent = std::min(samplesToEvent, engine.samplesToClockEvent());
             }
-        } else { // 32-bit mode
-            stepInSegmentForGateTrig = currentStep % wordLength;
-            bool firstHalf_forGate = (currentStep / wordLength) % 2 == 0;
-            if (stepInSegmentForGateTrig < wordLength) {
-                if (firstHalf_forGate) {
-                    triggerGateA = (displayWordA_forGate & (1 << stepInSegmentForGateTrig)) != 0;
-                    triggerGateB = (displayWordB_forGate & (1 << stepInSegmentForGateTrig)) != 0;
+            if (tickLanes & (1 << lane)) {
+                if (EXTERNAL_CLOCK) {
+                    if (!engine.isRunning) missed++;
+                    else if (args.frame - lastTickFrames[channel] < WordEngine::PULSE_DURATION * args.sampleRate) merged++;
+                    tickPeriods[channel] = args.frame - lastTickFrames[channel];
+                    lastTickFrames[channel] = args.frame;
+                }
+                // CVs may move together with the clock, so take them fresh rather than from the last poll
+                channelConfig = readChannelConfig(sharedConfig, channel);
+                bool wasComplete = engine.singleCycleComplete;
+                // Pattern changes land on word boundaries: the step is left with the old pattern, and
+                // the new one is mixed at this tick and starts from its first step
+                if (engine.isRunning && activePatterns[channel] != requestedPatterns[channel]
+                    && (engine.currentStep + 1) % WordEngine::wordSteps(channelConfig) == 0) {
+                    latchPattern(channel);
+                    WordEngine::Config next = readChannelConfig(sharedConfig, channel);
+                    events |= engine.advanceInto(channelConfig, next);
+                    channelConfig = next;
                 } else {
-                    triggerGateA = (displayWordB_forGate & (1 << stepInSegmentForGateTrig)) != 0;
-                    triggerGateB = (displayWordA_forGate & (1 << stepInSegmentForGateTrig)) != 0;
+                    events |= engine.advance(channelConfig);
+                }
+                bitsChanged = true;
+                if (engine.isRunning) {
+                    ticked++;
+                    uint32_t threshold = WordEngine::probabilityThreshold(channelConfig.prnProbability);
+                    if (threshold > 0 && threshold < 65536) prnDrawn += channelConfig.banks;
+                    if (engine.singleCycleComplete && !wasComplete) completed++;
                 }
             }
-        }
-        if (triggerGateA) wordAGatePulse.trigger(0.001f);
-        if (triggerGateB) wordBGatePulse.trigger(0.001f);
-
-        if (currentStep == 0) { firstBitPulse.trigger(0.001f); }
-        int effectiveSequenceLength = is16BitMode ? wordLength : (wordLength * 2);
-        if (currentStep == effectiveSequenceLength - 1) { lastBitPulse.trigger(0.001f); if (forceSingleCycle) { singleCycleComplete = true; } }
-        advanceSequence();
-    }
-
-    // Output Generation Block
-    bool bitA_out = false; bool bitB_out = false; int stepInCurrentSegment = 0;
-    bool currentEffectiveInvertA = params[INVERT_A_PARAM].getValue() > 0.5f;
-    bool currentEffectiveInvertB = params[INVERT_B_PARAM].getValue() > 0.5f;
-    uint16_t displayWordA = currentEffectiveInvertA ? (~stepFinalWordA & 0xFFFF) : stepFinalWordA;
-    uint16_t displayWordB = currentEffectiveInvertB ? (~stepFinalWordB & 0xFFFF) : stepFinalWordB;
-
-    if (is16BitMode) {
-        stepInCurrentSegment = currentStep % wordLength;
-        if (stepInCurrentSegment < wordLength) {
-            bitA_out = (displayWordA & (1 << stepInCurrentSegment)) != 0;
-            bitB_out = (displayWordB & (1 << stepInCurrentSegment)) != 0;
-        }
-    } else { // 32-bit mode
-        stepInCurrentSegment = currentStep % wordLength;
-        bool firstHalf = (currentStep / wordLength) % 2 == 0;
-        if (stepInCurrentSegment < wordLength) {
-            if (firstHalf) {
-                bitA_out = (displayWordA & (1 << stepInCurrentSegment)) != 0;
-                bitB_out = (displayWordB & (1 << stepInCurrentSegment)) != 0;
-            } else {
-                bitA_out = (displayWordB & (1 << stepInCurrentSegment)) != 0;
-                bitB_out = (displayWordA & (1 << stepInCurrentSegment)) != 0;
+            if (events) {
+                if (events & WordEngine::GATE_A_EVENT) triggerPulse(wordAGatePulses[g], lane);
+                if (events & WordEngine::GATE_B_EVENT) triggerPulse(wordBGatePulses[g], lane);
+                if (events & WordEngine::FIRST_BIT_EVENT) triggerPulse(firstBitPulses[g], lane);
+                if (events & WordEngine::LAST_BIT_EVENT) triggerPulse(lastBitPulses[g], lane);
+            }
+
+            if (bitsChanged) {
+                bool bitA_out, bitB_out;
+                engine.currentBits(channelConfig, bitA_out, bitB_out);
+                float wordACv = bitA_out ? 10.f : 0.f;
+                float wordBCv = bitB_out ? 10.f : 0.f;
+                if (AUDIO_RATE && !EXTERNAL_CLOCK && (tickLanes & (1 << lane))) {
+                    // Word edges sit at the tick's sub-sample position
+                    float offset = engine.tickOffset();
+                    if (wordACv != wordACvs[channel]) insertDiscontinuity(wordABleps[g], lane, offset, wordACv - wordACvs[channel]);
+                    if (wordBCv != wordBCvs[channel]) insertDiscontinuity(wordBBleps[g], lane, offset, wordBCv - wordBCvs[channel]);
+                }
+                wordACvs[channel] = wordACv;
+                wordBCvs[channel] = wordBCv;
+
+                // Parallel words: the bank now playing, masked to the word length
+                uint16_t mask = (1u << channelConfig.wordLength) - 1;
+                uint16_t wordA = engine.displayWordA(channelConfig, engine.cursorBank) & mask;
+                uint16_t wordB = engine.displayWordB(channelConfig, engine.cursorBank) & mask;
+                float dacScale = 10.f / (1 << channelConfig.wordLength);
+                wordADacs[channel] = wordA * dacScale;
+                wordBDacs[channel] = wordB * dacScale;
+                wordLanes |= 1 << lane;
+                if (channel == 0 && (wordA != parallelWordA || wordB != parallelWordB)) {
+                    parallelWordA = wordA;
+                    parallelWordB = wordB;
+                    writeParallelWord(WORD_A_PARALLEL_OUTPUT, wordA);
+                    writeParallelWord(WORD_B_PARALLEL_OUTPUT, wordB);
+                }
+            }
+            if (bertEnabled && (tickLanes & (1 << lane)) && engine.isRunning) {
+                BitErrorTester& tester = testers[channel];
+                bool synced = tester.synced;
+                int errors = tester.push(wordACvs[channel] > 0.f, inputs[DATA_INPUT].getPolyVoltage(channel) >= 1.f, channelConfig.wordLength);
+                if (errors >= 0 || tester.synced != synced) {
+                    if (errors > 0) triggerPulse(errorPulses[g], lane);
+                    if (errors >= 0) { comparedBits += channelConfig.wordLength; bitErrors += errors; }
+                    errorRates[channel] = errorRateVoltage(tester);
+                    testedLanes |= 1 << lane;
+                    if (channel == 0) stats.bertDelay.store(tester.synced ? tester.delay : -1, std::memory_order_relaxed);
+                }
+            }
+            if (derivedClocks) {
+                int sequenceLength = WordEngine::sequenceLength(channelConfig, channelConfig.wordLength);
+                float phase;
+                if (EXTERNAL_CLOCK) {
+                    // Phase estimated from the last period, so that x2 runs at twice a steady external clock
+                    phase = tickPeriods[channel] > 0 ? std::min((float)(args.frame - lastTickFrames[channel]) / tickPeriods[channel], 0.999f) : 0.f;
+                } else {
+                    phase = engine.scheduledPhase();
+                    if (outputs[CLOCK_X2_OUTPUT].isConnected()) samplesToEvent = std::min(samplesToEvent, engine.samplesToSubdivision(4));
+                }
+                // The step the last tick left is the one First Bit fires for, so position 0 is the word start
+                clockPositions[channel] = (engine.currentStep + sequenceLength - 1) % sequenceLength + phase;
+                sequenceLengths[channel] = sequenceLength;
+            }
+            if (channel == 0 && (tickLanes & 1)) {
+                uint8_t record = (wordACvs[0] > 0.f ? HISTORY_WORD_A : 0) | (wordBCvs[0] > 0.f ? HISTORY_WORD_B : 0) | (events << HISTORY_EVENTS_SHIFT);
+                history.push(record); // Dropped if the UI isn't draining, e.g. while the module is hidden
             }
         }
+
+        // Output Generation Block
+        if (wordLanes) {
+            outputs[WORD_A_DAC_OUTPUT].setVoltageSimd(simd::float_4::load(&wordADacs[c]), c);
+            outputs[WORD_B_DAC_OUTPUT].setVoltageSimd(simd::float_4::load(&wordBDacs[c]), c);
+        }
+        if (testedLanes) outputs[ERROR_RATE_OUTPUT].setVoltageSimd(simd::float_4::load(&errorRates[c]), c);
+        processCvOutputs<AUDIO_RATE>(c);
+        processPulseOutputs(c, args.sampleTime);
+        if (derivedClocks) processDerivedClocks(c);
     }
+    if (ticked) {
+        stats.ticks.add(ticked);
+        stats.prnDraws.add(prnDrawn);
+        stats.singleCycles.add(completed);
+    }
+    if (missed) stats.missedEdges.add(missed);
+    if (merged) stats.mergedEdges.add(merged);
+    if (comparedBits) {
+        stats.bitsCompared.add(comparedBits);
+        stats.bitErrors.add(bitErrors);
+    }
+    clockScheduleValid = !EXTERNAL_CLOCK;
+    controlsDirty = false;
+    skippedSamples = 0;
+    quietSamples = !EXTERNAL_CLOCK ? samplesToEvent - 1 : 0; // Samples before the next clock event
     
-    // RZ/NRZ logic removed here
-    outputs[WORD_A_CV_OUTPUT].setVoltage(bitA_out ? 10.f : 0.f);    // CV A output
-    outputs[WORD_B_CV_OUTPUT].setVoltage(bitB_out ? 10.f : 0.f);    // CV B output
-    outputs[WORD_A_GATE_OUTPUT].setVoltage(wordAGatePulse.process(args.sampleTime) ? 10.f : 0.f); // Gate A output
-    outputs[WORD_B_GATE_OUTPUT].setVoltage(wordBGatePulse.process(args.sampleTime) ? 10.f : 0.f); // Gate B output
-
-    outputs[FIRST_BIT_OUTPUT].setVoltage(firstBitPulse.process(args.sampleTime) ? 10.f : 0.f);
-    outputs[LAST_BIT_OUTPUT].setVoltage(lastBitPulse.process(args.sampleTime) ? 10.f : 0.f);
-    
-    for (int i = 0; i < 16; ++i) {
-        if (i >= wordLength) { lights[BIT_A_LIGHTS + i].setBrightness(0.1f); lights[BIT_B_LIGHTS + i].setBrightness(0.1f); }
-        else { lights[BIT_A_LIGHTS + i].setBrightness((displayWordA & (1 << i)) ? 1.f : 0.f); lights[BIT_B_LIGHTS + i].setBrightness((displayWordB & (1 << i)) ? 1.f : 0.f); }
+    if (lightDivider.process()) updateLights();
+}
+
+// Gate voltages of the four channels a word nibble drives
+static const simd::float_4 NIBBLE_VOLTAGES[16] = {
+    {0.f, 0.f, 0.f, 0.f}, {10.f, 0.f, 0.f, 0.f}, {0.f, 10.f, 0.f, 0.f}, {10.f, 10.f, 0.f, 0.f},
+    {0.f, 0.f, 10.f, 0.f}, {10.f, 0.f, 10.f, 0.f}, {0.f, 10.f, 10.f, 0.f}, {10.f, 10.f, 10.f, 0.f},
+    {0.f, 0.f, 0.f, 10.f}, {10.f, 0.f, 0.f, 10.f}, {0.f, 10.f, 0.f, 10.f}, {10.f, 10.f, 0.f, 10.f},
+    {0.f, 0.f, 10.f, 10.f}, {10.f, 0.f, 10.f, 10.f}, {0.f, 10.f, 10.f, 10.f}, {10.f, 10.f, 10.f, 10.f},
+};
+
+void WordGenerator::writeParallelWord(int output, uint16_t word) {
+    for (int i = 0; i < 16; i += 4) outputs[output].setVoltageSimd(NIBBLE_VOLTAGES[(word >> i) & 0xF], i);
+}
+
+template <bool AUDIO_RATE>
+void WordGenerator::processCvOutputs(int c) {
+    int g = c / 4;
+    simd::float_4 wordACv = simd::float_4::load(&wordACvs[c]);
+    simd::float_4 wordBCv = simd::float_4::load(&wordBCvs[c]);
+    simd::float_4 clockCv = simd::float_4::load(&clockCvs[c]);
+    if (AUDIO_RATE) {
+        wordACv += wordABleps[g].process();
+        wordBCv += wordBBleps[g].process();
+        clockCv += clockBleps[g].process();
     }
+    outputs[WORD_A_CV_OUTPUT].setVoltageSimd(wordACv, c);
+    outputs[WORD_B_CV_OUTPUT].setVoltageSimd(wordBCv, c);
+    outputs[CLOCK_OUTPUT].setVoltageSimd(clockCv, c);
+}
+
+static inline simd::float_4 squareWave(simd::float_4 position) {
+    return simd::ifelse(position - simd::floor(position) < 0.5f, 10.f, 0.f);
+}
+
+// All derived clocks of four channels in one pass. Positions between clock events need no update:
+// x2 edges are scheduled as events while it's patched, the others only move at a tick or the fall.
+void WordGenerator::processDerivedClocks(int c) {
+    simd::float_4 position = simd::float_4::load(&clockPositions[c]);
+    simd::float_4 sequenceLength = simd::float_4::load(&sequenceLengths[c]);
+    outputs[CLOCK_X2_OUTPUT].setVoltageSimd(squareWave(2.f * position), c);
+    outputs[CLOCK_DIV2_OUTPUT].setVoltageSimd(squareWave(0.5f * position), c);
+    outputs[CLOCK_DIV4_OUTPUT].setVoltageSimd(squareWave(0.25f * position), c);
+    outputs[WORD_CLOCK_OUTPUT].setVoltageSimd(simd::ifelse(position < 0.5f * sequenceLength, 10.f, 0.f), c);
 }
 
-void WordGenerator::advanceSequence() {
-    int wordLen = std::max(1, (int)std::round(params[WORD_LENGTH_PARAM].getValue())); // Re-read for safety, though wordLength from process() could be passed
-    bool is16Bit = params[MODE_PARAM].getValue() < 0.5f;
-    int runModeVal = std::round(params[RUN_MODE_PARAM].getValue());
-    if ((runModeVal == 1 || forceSingleCycle) && singleCycleComplete) { return; }
-    currentStep++;
-    int effectiveSeqLen = is16Bit ? wordLen : (wordLen * 2);
-    if (currentStep >= effectiveSeqLen) { currentStep = 0; }
+void WordGenerator::processPulseOutputs(int c, float sampleTime) {
+    int g = c / 4;
+    outputs[WORD_A_GATE_OUTPUT].setVoltageSimd(processPulses(wordAGatePulses[g], sampleTime), c);
+    outputs[WORD_B_GATE_OUTPUT].setVoltageSimd(processPulses(wordBGatePulses[g], sampleTime), c);
+    outputs[FIRST_BIT_OUTPUT].setVoltageSimd(processPulses(firstBitPulses[g], sampleTime), c);
+    outputs[LAST_BIT_OUTPUT].setVoltageSimd(processPulses(lastBitPulses[g], sampleTime), c);
+    outputs[ERROR_OUTPUT].setVoltageSimd(processPulses(errorPulses[g], sampleTime), c);
+}
+
+// The generated sequence jumped, so the round trip has to be found again
+void WordGenerator::restartTester(int channel) {
+    testers[channel].restart();
+    errorRates[channel] = bertActive ? 10.f : 0.f;
+    if (channel == 0) stats.bertDelay.store(-1, std::memory_order_relaxed);
+}
+
+// 1 V per decade: 10 V at a rate of 1, 0 V at 1e-10 and below or with no errors yet.
+// Out of sync reads as a rate of 1.
+float WordGenerator::errorRateVoltage(const BitErrorTester& tester) {
+    if (!tester.synced) return 10.f;
+    double rate = tester.errorRate();
+    return rate > 0.0 ? clamp(10.f + (float)std::log10(rate), 0.f, 10.f) : 0.f;
 }
 
 uint8_t WordGenerator::computeOutputByte(uint16_t word, int startBit) {
@@ -256,12 +793,101 @@ uint8_t WordGenerator::computeOutputByte(uint16_t word, int startBit) {
     return result;
 }
 
-uint32_t WordGenerator::generatePRN(uint32_t state) {
-    uint32_t bit = ((state >> 0) ^ (state >> 1) ^ (state >> 21) ^ (state >> 31)) & 1;
-    return (state >> 1) | (bit << 31);
-}
+// Scrolling timing diagram of channel 1, one column per tick, newest on the right.
+// Traces from the top: clock, Word A, Word B, Gate A, Gate B, First Bit, Last Bit.
+struct WordHistoryDisplay : TransparentWidget {
+    static constexpr int COLUMNS = 64;
+    static constexpr int TRACES = 7;
+
+    WordGenerator* module = nullptr;
+    uint8_t records[COLUMNS] = {}; // Circular, oldest at `next`
+    int next = 0;
+
+    void step() override {
+        if (module) {
+            module->history.drain([&](uint8_t record) {
+                records[next] = record;
+                next = (next + 1) % COLUMNS;
+            });
+        }
+        TransparentWidget::step();
+    }
+
+    void draw(const DrawArgs& args) override {
+        nvgBeginPath(args.vg);
+        nvgRect(args.vg, 0, 0, box.size.x, box.size.y);
+        nvgFillColor(args.vg, nvgRGB(0x10, 0x14, 0x10));
+        nvgFill(args.vg);
+        TransparentWidget::draw(args);
+    }
+
+    void drawLayer(const DrawArgs& args, int layer) override {
+        if (layer == 1 && module) drawTraces(args);
+        TransparentWidget::drawLayer(args, layer);
+    }
+
+    void drawTraces(const DrawArgs& args) {
+        static const NVGcolor colors[TRACES] = {
+            nvgRGB(0xa0, 0xa0, 0xa0), nvgRGB(0x40, 0xe0, 0x40), nvgRGB(0x40, 0xc0, 0xf0),
+            nvgRGB(0x40, 0xa0, 0x40), nvgRGB(0x40, 0x80, 0xb0), nvgRGB(0xf0, 0xd0, 0x40), nvgRGB(0xf0, 0x70, 0x40),
+        };
+        float columnWidth = box.size.x / COLUMNS;
+        float traceHeight = box.size.y / TRACES;
+        nvgStrokeWidth(args.vg, 1.f);
+        for (int trace = 0; trace < TRACES; trace++) {
+            float high = trace * traceHeight + 0.2f * traceHeight;
+            float low = trace * traceHeight + 0.8f * traceHeight;
+            nvgBeginPath(args.vg);
+            nvgMoveTo(args.vg, 0, low);
+            for (int i = 0; i < COLUMNS; i++) {
+                uint8_t record = records[(next + i) % COLUMNS];
+                float x = i * columnWidth;
+                if (trace == 0) { // Clock: high for the first half of each tick
+                    nvgLineTo(args.vg, x, low); nvgLineTo(args.vg, x, high);
+                    nvgLineTo(args.vg, x + 0.5f * columnWidth, high); nvgLineTo(args.vg, x + 0.5f * columnWidth, low);
+                } else if (trace <= 2) { // Word levels, held for the whole tick
+                    float y = (record & (trace == 1 ? WordGenerator::HISTORY_WORD_A : WordGenerator::HISTORY_WORD_B)) ? high : low;
+                    nvgLineTo(args.vg, x, y); nvgLineTo(args.vg, x + columnWidth, y);
+                } else if (record & (1 << (WordGenerator::HISTORY_EVENTS_SHIFT + trace - 3))) { // Pulses at the tick
+                    nvgLineTo(args.vg, x, low); nvgLineTo(args.vg, x, high);
+                    nvgLineTo(args.vg, x + 0.3f * columnWidth, high); nvgLineTo(args.vg, x + 0.3f * columnWidth, low);
+                }
+            }
+            nvgLineTo(args.vg, box.size.x, low);
+            nvgStrokeColor(args.vg, colors[trace]);
+            nvgStroke(args.vg);
+        }
+    }
+};
+
+// Context menu entry for a 64-bit number, applied with Enter
+struct NumberMenuField : ui::TextField {
+    std::function<void(uint64_t)> action;
+
+    NumberMenuField(uint64_t value, std::function<void(uint64_t)> action) : action(action) {
+        box.size.x = 160;
+        text = std::to_string(value);
+        selectAll();
+    }
+
+    void onSelectKey(const SelectKeyEvent& e) override {
+        if (e.action == GLFW_PRESS && (e.key == GLFW_KEY_ENTER || e.key == GLFW_KEY_KP_ENTER)) {
+            action(std::strtoull(text.c_str(), nullptr, 10));
+            ui::MenuOverlay* overlay = getAncestorOfType<ui::MenuOverlay>();
+            if (overlay) overlay->requestDelete();
+            e.consume(this);
+        }
+        if (!e.getTarget()) TextField::onSelectKey(e);
+    }
+};
 
 struct WordGeneratorWidget : ModuleWidget {
+    void step() override {
+        WordGenerator* module = getModule<WordGenerator>();
+        if (module) module->collectRetiredStream();
+        ModuleWidget::step();
+    }
+
     WordGeneratorWidget(WordGenerator* module) {
         setModule(module);
         setPanel(createPanel(asset::plugin(pluginInstance, "res/WordGenerator.svg")));
@@ -291,6 +917,23 @@ struct WordGeneratorWidget : ModuleWidget {
         addParam(createParamCentered<CKSS>(mm2px(Vec(105, 40)), module, WordGenerator::MODE_PARAM)); // 16/32 bit mode
         addInput(createInputCentered<PJ301MPort>(mm2px(Vec(120, 40)), module, WordGenerator::MODE_FLIP_TRIGGER_INPUT));
 
+        // Area 3b: Pattern memory (Pattern Knob + Select CV)
+        auto patternKnob = createParamCentered<RoundBlackKnob>(mm2px(Vec(140, 20)), module, WordGenerator::PATTERN_PARAM);
+        patternKnob->snap = true;
+        addParam(patternKnob);
+        addInput(createInputCentered<PJ301MPort>(mm2px(Vec(140, 40)), module, WordGenerator::PATTERN_CV_INPUT));
+
+        // Bit-error-rate tester (Data In, Error Pulse, Error Rate) - third row of the right grid
+        addInput(createInputCentered<PJ301MPort>(mm2px(Vec(159, 49)), module, WordGenerator::DATA_INPUT));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(177, 49)), module, WordGenerator::ERROR_OUTPUT));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(195, 49)), module, WordGenerator::ERROR_RATE_OUTPUT));
+
+        // Derived clocks (Word Clock, /2, /4, x2) - bottom row of the right grid
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(195, 65)), module, WordGenerator::CLOCK_X2_OUTPUT));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(159, 65)), module, WordGenerator::WORD_CLOCK_OUTPUT));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(171, 65)), module, WordGenerator::CLOCK_DIV2_OUTPUT));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(183, 65)), module, WordGenerator::CLOCK_DIV4_OUTPUT));
+
         // Area 4: PRN Control (PRN Prob Knob + CV)
         addParam(createParamCentered<RoundBlackKnob>(mm2px(Vec(20, 60)), module, WordGenerator::PRN_PROB_PARAM));
         addInput(createInputCentered<PJ301MPort>(mm2px(Vec(35, 60)), module, WordGenerator::PRN_PROBABILITY_INPUT));
@@ -302,13 +945,23 @@ struct WordGeneratorWidget : ModuleWidget {
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(125, 60)), module, WordGenerator::FIRST_BIT_OUTPUT));
         addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(145, 60)), module, WordGenerator::LAST_BIT_OUTPUT));
         
-        // Area 7: Main Outputs (Word A CV/Gate, Word B CV/Gate) - Right Column
+        // Area 7: Main Outputs - Right grid, a column per output kind and a row per word
         // Word A Outputs
-        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(160, 30)), module, WordGenerator::WORD_A_CV_OUTPUT));
-        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(175, 30)), module, WordGenerator::WORD_A_GATE_OUTPUT));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(159, 22)), module, WordGenerator::WORD_A_CV_OUTPUT));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(171, 22)), module, WordGenerator::WORD_A_GATE_OUTPUT));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(183, 22)), module, WordGenerator::WORD_A_PARALLEL_OUTPUT));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(195, 22)), module, WordGenerator::WORD_A_DAC_OUTPUT));
         // Word B Outputs
-        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(160, 50)), module, WordGenerator::WORD_B_CV_OUTPUT));
-        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(175, 50)), module, WordGenerator::WORD_B_GATE_OUTPUT));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(159, 33)), module, WordGenerator::WORD_B_CV_OUTPUT));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(171, 33)), module, WordGenerator::WORD_B_GATE_OUTPUT));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(183, 33)), module, WordGenerator::WORD_B_PARALLEL_OUTPUT));
+        addOutput(createOutputCentered<PJ301MPort>(mm2px(Vec(195, 33)), module, WordGenerator::WORD_B_DAC_OUTPUT));
+
+        // Timing diagram of the last ticks
+        WordHistoryDisplay* historyDisplay = createWidget<WordHistoryDisplay>(mm2px(Vec(57, 27)));
+        historyDisplay->box.size = mm2px(Vec(41, 25));
+        historyDisplay->module = module;
+        addChild(historyDisplay);
 
         // BOTTOM SECTION: WORD A (Controls and Bits)
         // Invert A Switch & Flip Trigger Jack
@@ -337,6 +990,64 @@ struct WordGeneratorWidget : ModuleWidget {
             addChild(createLightCentered<SmallLight<GreenLight>>(mm2px(Vec(bitSwitchStartX_B + i * bitSwitchSpacingX, bitLightY_B)), module, WordGenerator::BIT_B_LIGHTS + i));
         }
     }
+
+    void appendContextMenu(Menu* menu) override {
+        WordGenerator* module = getModule<WordGenerator>();
+        menu->addChild(new MenuSeparator);
+        menu->addChild(createBoolMenuItem("Audio-rate clock", "",
+            [=]() { return module->audioRate; },
+            [=](bool enabled) { module->setAudioRate(enabled); }));
+
+        menu->addChild(new MenuSeparator);
+        menu->addChild(createSubmenuItem("Statistics", "", [=](Menu* menu) {
+            WordStats& stats = module->stats;
+            double nanoseconds = module->stats.nanosecondsPerCall();
+            float sampleRate = APP->engine->getSampleRate();
+            menu->addChild(createMenuLabel(module->settingsSummary()));
+            menu->addChild(createMenuLabel(string::f("Ticks: %llu (%.0f/s)", (unsigned long long)stats.ticks.get(), stats.ticksPerSecond.load(std::memory_order_relaxed))));
+            menu->addChild(createMenuLabel(string::f("PRN draws: %llu", (unsigned long long)stats.prnDraws.get())));
+            menu->addChild(createMenuLabel(string::f("Single cycles completed: %llu", (unsigned long long)stats.singleCycles.get())));
+            menu->addChild(createMenuLabel(string::f("Clock edges missed: %llu, merged: %llu", (unsigned long long)stats.missedEdges.get(), (unsigned long long)stats.mergedEdges.get())));
+            menu->addChild(createMenuLabel(string::f("process(): %.0f ns/call, %.2f%% of a sample period", nanoseconds, nanoseconds * 1e-7 * sampleRate)));
+            int bertDelay = stats.bertDelay.load(std::memory_order_relaxed);
+            uint64_t bitsCompared = stats.bitsCompared.get();
+            uint64_t bitErrors = stats.bitErrors.get();
+            if (!module->inputs[WordGenerator::DATA_INPUT].isConnected()) menu->addChild(createMenuLabel("BERT: data input not patched"));
+            else if (bertDelay < 0) menu->addChild(createMenuLabel("BERT: searching for sync"));
+            else menu->addChild(createMenuLabel(string::f("BERT: in sync, %d tick round trip", bertDelay)));
+            menu->addChild(createMenuLabel(string::f("Bit errors: %llu in %llu bits (BER %.2e)", (unsigned long long)bitErrors, (unsigned long long)bitsCompared,
+                bitsCompared ? (double)bitErrors / bitsCompared : 0.0)));
+            menu->addChild(createMenuItem("Clear statistics", "", [=]() { module->stats.clearRequested.store(true, std::memory_order_relaxed); }));
+            menu->addChild(createBoolPtrMenuItem("Save statistics in patch", "", &module->saveStats));
+        }));
+        menu->addChild(createBoolMenuItem("Seeded reset", "",
+            [=]() { return module->seeded; },
+            [=](bool enabled) { module->seeded = enabled; }));
+        menu->addChild(createMenuLabel("Seed (Enter to apply)"));
+        menu->addChild(new NumberMenuField(module->seed, [=](uint64_t value) { module->seed = value; }));
+        menu->addChild(createMenuLabel(string::f("Seek to tick (now at %llu, Enter to jump)", (unsigned long long)module->engines[0].tickCount)));
+        menu->addChild(new NumberMenuField(module->engines[0].tickCount, [=](uint64_t value) { module->requestSeek(value); }));
+
+        menu->addChild(new MenuSeparator);
+        std::string streamPath = module->streamPath;
+        menu->addChild(createMenuLabel(streamPath.empty() ? "Bitstream playback: off" : "Bitstream: " + system::getFilename(streamPath)));
+        menu->addChild(createMenuItem("Load bitstream file...", "", [=]() {
+            char* path = osdialog_file(OSDIALOG_OPEN, streamPath.empty() ? nullptr : system::getDirectory(streamPath).c_str(), nullptr, nullptr);
+            if (!path) return;
+            if (!module->loadStream(path)) WARN("Word Generator: could not map bitstream %s", path);
+            std::free(path);
+        }));
+        menu->addChild(createMenuItem("Stop bitstream playback", "", [=]() { module->unloadStream(); }, streamPath.empty()));
+
+        int pattern = module->selectedPattern();
+        menu->addChild(new MenuSeparator);
+        menu->addChild(createMenuLabel(pattern > 0 ? string::f("Pattern %d", pattern) : "Pattern: panel switches"));
+        menu->addChild(createMenuItem("Store switches in pattern", "", [=]() { module->storePattern(pattern); }, pattern < 1));
+        bool stored = pattern > 0 && module->patternMemory.isStored(pattern - 1);
+        menu->addChild(createMenuItem("Load pattern to switches", "", [=]() { module->loadPattern(pattern); }, !stored));
+        menu->addChild(createMenuItem("Clear pattern", "", [=]() { module->clearPattern(pattern); }, !stored));
+        menu->addChild(createMenuItem("Clear all patterns", "", [=]() { module->clearAllPatterns(); }));
+    }
 };
 
 Model* modelWordGenerator = createModel<WordGenerator, WordGeneratorWidget>("WordGenerator"); 
\ No newline at end of file
@@ -1,5 +1,13 @@
 #pragma once
 #include "plugin.hpp"
+#include "WordEngine.hpp"
+#include "WordBus.hpp"
+#include "WordPatterns.hpp"
+#include "WordStats.hpp"
+#include "SpscRing.hpp"
+#include "Bitstream.hpp"
+#include "BitErrorTester.hpp"
+#include <atomic>
 
 struct WordGenerator : rack::Module {
     enum ParamIds {
@@ -21,6 +29,8 @@ struct WordGenerator : rack::Module {
         BIT_B_PARAMS,               // Starts at BIT_A_PARAMS + 16
         BIT_B_PARAMS_LAST = BIT_B_PARAMS + 15,
 
+        PATTERN_PARAM,              // 0: panel switches, 1..256: stored patterns
+
         NUM_PARAMS
     };
     
@@ -34,6 +44,8 @@ struct WordGenerator : rack::Module {
         WORD_LENGTH_CV_INPUT,     // New: CV for Word Length
         MODE_FLIP_TRIGGER_INPUT,  // New: Trigger to flip 16/32 bit mode
         RATE_CV_INPUT,            // New: CV for Clock Rate
+        PATTERN_CV_INPUT,         // Pattern select, added to the Pattern knob
+        DATA_INPUT,               // BERT: bits back from the device under test, sampled at each tick
         NUM_INPUTS
     };
     
@@ -45,6 +57,16 @@ struct WordGenerator : rack::Module {
         FIRST_BIT_OUTPUT,
         LAST_BIT_OUTPUT,
         CLOCK_OUTPUT,
+        WORD_A_PARALLEL_OUTPUT, // Channel 1's current word, bit i on channel i
+        WORD_B_PARALLEL_OUTPUT,
+        WORD_A_DAC_OUTPUT,      // Current word as one voltage per channel
+        WORD_B_DAC_OUTPUT,
+        ERROR_OUTPUT,           // BERT: pulse at the end of a word received with errors
+        ERROR_RATE_OUTPUT,      // BERT: 1 V per decade of bit error rate, 10 V at 1 or out of sync
+        CLOCK_X2_OUTPUT,        // Derived clocks, phase-locked to the word start
+        CLOCK_DIV2_OUTPUT,
+        CLOCK_DIV4_OUTPUT,
+        WORD_CLOCK_OUTPUT,      // One cycle per sequence, rising with First Bit
         NUM_OUTPUTS
     };
     
@@ -58,44 +80,178 @@ struct WordGenerator : rack::Module {
         NUM_LIGHTS
     };
     
+    static constexpr int MAX_CHANNELS = 16;
+    static constexpr int NUM_GROUPS = MAX_CHANNELS / 4; // float_4 lanes per group
+    static constexpr int CONTROL_DIVISION = 16;              // Samples between polls of the params and CV-driven settings
+    static constexpr int LIGHT_DIVISION = 512;               // Samples between light refreshes
+    static constexpr float RATE_RESCHEDULE_THRESHOLD = 1e-3f; // log2 Hz change that reschedules the internal clock
+    static constexpr float AUDIO_RATE_OCTAVES = 6.f;          // Audio-rate mode shifts the rate knob up by this many octaves
+    static constexpr float MAX_AUDIO_RATE_FRACTION = 0.45f;   // Highest audio-rate clock, as a fraction of the sample rate
+    static constexpr int PROFILE_INTERVAL = 256;              // process() calls per timed call
+    static constexpr size_t HISTORY_CAPACITY = 1024;          // Tick records queued for the timing diagram
+    static constexpr float PATTERN_CV_SCALE = PatternMemory::NUM_PATTERNS / 10.f; // Patterns per volt, 10 V selects the last
+
+    // Per-sample kernel, chosen by selectKernel() when the clock source or audio-rate setting changes
+    typedef void (WordGenerator::*Kernel)(const ProcessArgs& args, bool singleCycleStart, bool seek);
+
+    // Hot state: the kernel and control bookkeeping every sample goes through, kept together ahead of
+    // the cold configuration and UI state. Quiet samples also read the params, inputs, scheduled rates,
+    // pulse timers and outputs, so this groups the scalars rather than fitting one cache line.
+    Kernel kernel;
+    int channels = 1;       // Polyphony, taken from the widest of the clock/reset/length/PRN/rate inputs
+    int quietSamples = 0;   // Upcoming samples known to hold no clock event; they take the fast path
+    int skippedSamples = 0; // Fast-path samples not yet applied to the engines' clocks
+    int profileCounter = 0;
+    int statsWindowFrames = 0;
+    int lastClockMode = -1;
+    dsp::ClockDivider controlDivider; // Params and word length/PRN CVs are polled every CONTROL_DIVISION samples
+    dsp::ClockDivider lightDivider;
+    bool controlsDirty = true; // Something that selects the current output bits changed
+    bool audioRate = false;    // Internal clock runs up to MAX_AUDIO_RATE_FRACTION of the sample rate with band-limited edges
+    bool lastAudioRate = false;
+    bool clockScheduleValid = false;
+
     // Module state
     uint16_t wordA_switches = 0;
     uint16_t wordB_switches = 0;
-    int currentStep = 0;
-    bool clockInputState = false;
-    float clockPhase = 0.f;
+    int expanders = 0; // WordExpanders chained to the right, each adding a bank
+    bool seeded = false; // Resets start from `seed` (plus the channel index) instead of a random seed
+    uint64_t seed = 0;
+    // Tick history for the timing diagram, channel 1 only. One record per tick: bits 0-1 are the
+    // Word A/B outputs after the tick, bits 2-5 the WordEngine::Events it fired.
+    enum HistoryBits {
+        HISTORY_WORD_A = 1 << 0,
+        HISTORY_WORD_B = 1 << 1,
+        HISTORY_EVENTS_SHIFT = 2,
+    };
+    SpscRing<uint8_t, HISTORY_CAPACITY> history; // Audio thread to UI thread
+    
+    // Instrumentation, always on. Counters are gathered per call and published once at its end.
+    WordStats stats;
+    bool saveStats = false;     // Dump the counters into the patch JSON
+    uint64_t statsWindowTicks = 0; // Ticks at the start of the ticks-per-second window
+    int64_t lastTickFrames[MAX_CHANNELS]; // For merged external clock edges
+    // Tick requested from the context menu, taken up by the next process(). The UI thread publishes
+    // the tick and the pending flag in one word, so the audio thread never sees one without the other.
+    static constexpr uint64_t SEEK_PENDING = 1ull << 63;
+    std::atomic<uint64_t> seekRequest{0};
+    uint64_t seekTick = 0; // Audio thread copy of the taken request
+    
+    WordBankMessage bankMessages[2]; // Right expander buffers, written in place by the expanders
+    
+    // Bitstream playback. Files are mapped on the UI thread and handed over through
+    // pendingStream; the audio thread swaps them in and passes the old one back through
+    // retiredStream to be unmapped off the audio thread. An empty file stops playback.
+    BitstreamFile* stream = nullptr;                   // Audio thread only
+    std::atomic<BitstreamFile*> pendingStream{nullptr};
+    std::atomic<BitstreamFile*> retiredStream{nullptr};
+    std::string streamPath;                            // UI thread, empty when not playing
+    
+    // Stored patterns. Each channel plays the pattern selected by the knob and its CV, switching
+    // only when a word ends so that recalls stay in step.
+    PatternMemory patternMemory; // Written by the audio thread only, the menu queues its edits in patternRequest
+    int requestedPatterns[MAX_CHANNELS] = {}; // Selection at the last control poll, 0 for the panel
+    int activePatterns[MAX_CHANNELS] = {};    // Selection the channel is playing
+    // Menu edit taken up by the next process(): the operation in the high bits, the pattern index below
+    enum PatternRequest : uint32_t {
+        PATTERN_INDEX_MASK = 0xFFFF,
+        PATTERN_STORE = 1 << 16,
+        PATTERN_CLEAR = 2 << 16,
+        PATTERN_CLEAR_ALL = 3 << 16,
+    };
+    std::atomic<uint32_t> patternRequest{0};
+    
+    WordEngine engines[MAX_CHANNELS]; // Sequencing core per channel: step counter, PRN state
+    
+    // Control-rate state: the per-channel output bits are only recomputed when controlsDirty
+    WordEngine::Config sharedConfig;
+    WordEngine::Config channelConfigs[MAX_CHANNELS];
+    uint16_t shownWordA = 0; // Lights state at the last refresh
+    uint16_t shownWordB = 0;
+    int shownWordLength = -1;
     
-    bool isRunning = true;
-    bool singleCycleComplete = false;
-    bool forceSingleCycle = false;
+    // Event-scheduled internal clock, see quietSamples
+    simd::float_4 scheduledRates[NUM_GROUPS]; // log2 Hz each channel's clock was scheduled for
     
-    uint32_t prnState = 0x1; // For generating random bits
-    uint16_t currentPrnPatternA = 0; // Stores the 16-bit random pattern for Word A for the current step
-    uint16_t currentPrnPatternB = 0; // Stores the 16-bit random pattern for Word B for the current step
-    uint16_t stepFinalWordA = 0;     // Word A content (switches or PRN) decided at the last clock tick
-    uint16_t stepFinalWordB = 0;     // Word B content (switches or PRN) decided at the last clock tick
+    // Per-channel pulse state, processed four channels at a time
+    simd::float_4 wordAGatePulses[NUM_GROUPS]; // Remaining pulse time, same semantics as dsp::PulseGenerator
+    simd::float_4 wordBGatePulses[NUM_GROUPS];
+    simd::float_4 firstBitPulses[NUM_GROUPS];
+    simd::float_4 lastBitPulses[NUM_GROUPS];
+    simd::float_4 errorPulses[NUM_GROUPS];
+    float wordACvs[MAX_CHANNELS] = {}; // Naive output voltages, held between events
+    float wordBCvs[MAX_CHANNELS] = {};
+    float clockCvs[MAX_CHANNELS] = {};
+    // Parallel word outputs, rewritten only when a word changes
+    float wordADacs[MAX_CHANNELS] = {};
+    float wordBDacs[MAX_CHANNELS] = {};
+    uint16_t parallelWordA = 0; // Words on the parallel outputs, channel 1
+    uint16_t parallelWordB = 0;
+    // Bit-error-rate tester per channel, comparing DATA_INPUT against Word A while it's patched
+    BitErrorTester testers[MAX_CHANNELS];
+    float errorRates[MAX_CHANNELS] = {};
+    bool bertActive = false; // DATA_INPUT was patched at the last full sample
+    // Derived clocks. A channel's position counts ticks since the word start, with the clock phase
+    // as its fraction; every derived clock is a square wave of it.
+    float clockPositions[MAX_CHANNELS] = {};
+    float sequenceLengths[MAX_CHANNELS] = {};
+    int64_t tickPeriods[MAX_CHANNELS] = {}; // External clock: frames between the last two ticks, for the phase
+    // Band-limiting corrections for the audio-rate mode
+    dsp::MinBlepGenerator<16, 16, simd::float_4> wordABleps[NUM_GROUPS];
+    dsp::MinBlepGenerator<16, 16, simd::float_4> wordBBleps[NUM_GROUPS];
+    dsp::MinBlepGenerator<16, 16, simd::float_4> clockBleps[NUM_GROUPS];
     
     // Trigger outputs & helpers
-    dsp::PulseGenerator firstBitPulse;
-    dsp::PulseGenerator lastBitPulse;
-    dsp::PulseGenerator wordAGatePulse; // New for Word A Gate output
-    dsp::PulseGenerator wordBGatePulse; // New for Word B Gate output
-    // dsp::PulseGenerator manualClockPulse; // REMOVED as manual clock mode is removed
-    dsp::SchmittTrigger clockTrigger;
+    dsp::TSchmittTrigger<simd::float_4> clockTriggers[NUM_GROUPS];
+    dsp::TSchmittTrigger<simd::float_4> resetTriggers[NUM_GROUPS];
     dsp::SchmittTrigger singleCycleButtonTrigger;
-    dsp::SchmittTrigger resetTrigger;
     dsp::SchmittTrigger manualExtTrigger; // For single cycle via MANUAL_TRIGGER_INPUT
     dsp::SchmittTrigger invertAFlipTrigger; // New: for INVERT_A_FLIP_TRIGGER_INPUT
     dsp::SchmittTrigger invertBFlipTrigger; // New: for INVERT_B_FLIP_TRIGGER_INPUT
     dsp::SchmittTrigger modeFlipTrigger;    // New: for MODE_FLIP_TRIGGER_INPUT
     
     WordGenerator();
+    ~WordGenerator();
     void process(const ProcessArgs& args) override;
+    json_t* dataToJson() override;
+    void dataFromJson(json_t* rootJ) override;
+    void setAudioRate(bool enabled);
+    int selectedPattern(); // Knob selection, 0 for the panel
+    void storePattern(int pattern);
+    void loadPattern(int pattern);
+    void clearPattern(int pattern);
+    void clearAllPatterns();
+    void requestSeek(uint64_t tick);
+    bool loadStream(const std::string& path);
+    void unloadStream();
+    void collectRetiredStream();
+    json_t* statsToJson();
+    std::string settingsSummary();
     
 private:
+    void processFrame(const ProcessArgs& args);
+    void swapStream();
+    static Kernel selectKernel(bool externalClock, bool audioRate);
+    template <bool EXTERNAL_CLOCK, bool AUDIO_RATE>
+    void processKernel(const ProcessArgs& args, bool singleCycleStart, bool seek);
+    void updateStatsWindow(float sampleRate);
     uint8_t computeOutputByte(uint16_t word, int startBit);
-    void advanceSequence();
-    uint32_t generatePRN(uint32_t state); // Still useful for getting raw random bits
+    WordEngine::Config readConfig();
+    void readSwitches(uint16_t& wordA, uint16_t& wordB);
+    WordEngine::Config readChannelConfig(const WordEngine::Config& shared, int channel);
+    void refreshControls();
+    void latchPattern(int channel);
+    void applyPatternRequest(uint32_t request);
+    uint64_t resetSeed(int channel);
+    void updateLights();
+    void updateExpanderDisplays();
+    void processPulseOutputs(int c, float sampleTime);
+    void writeParallelWord(int output, uint16_t word);
+    void restartTester(int channel);
+    static float errorRateVoltage(const BitErrorTester& tester);
+    template <bool AUDIO_RATE>
+    void processCvOutputs(int c);
+    void processDerivedClocks(int c);
 };
 
 extern rack::Model* modelWordGenerator; 
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+#include "WordEngine.hpp"
+
+#include <cstdio>
+#include <string>
+
+// One stored word pair with the length and mode it plays with, packed into 6 bytes
+struct WordPattern {
+    enum Flags {
+        STORED = 1 << 0,      // Empty slots leave the panel settings in place
+        MODE_32_BIT = 1 << 1,
+    };
+
+    uint16_t wordA = 0;
+    uint16_t wordB = 0;
+    uint8_t wordLength = 16;
+    uint8_t flags = 0;
+};
+
+// Pattern memory recalled by index. Recall only swaps which entry the channel config is built
+// from, so a pattern change costs one index update instead of 32 switch writes.
+struct PatternMemory {
+    static constexpr int NUM_PATTERNS = 256;
+    static constexpr int HEX_CHARS = 12; // Per pattern in toHex(): wordA, wordB, length, flags
+
+    WordPattern patterns[NUM_PATTERNS];
+
+    bool isStored(int index) const { return patterns[index].flags & WordPattern::STORED; }
+
+    // Stores bank 0 of the config with its length and mode
+    void store(int index, const WordEngine::Config& config) {
+        WordPattern& pattern = patterns[index];
+        pattern.wordA = config.wordA_switches[0];
+        pattern.wordB = config.wordB_switches[0];
+        pattern.wordLength = (uint8_t)config.wordLength;
+        pattern.flags = WordPattern::STORED | (config.is16BitMode ? 0 : WordPattern::MODE_32_BIT);
+    }
+
+    void clear(int index) { patterns[index] = WordPattern(); }
+    void clearAll() { for (int i = 0; i < NUM_PATTERNS; i++) clear(i); }
+
+    // Replaces bank 0 and the length/mode of the config, before any length CV is added
+    void apply(int index, WordEngine::Config& config) const {
+        const WordPattern& pattern = patterns[index];
+        if (!(pattern.flags & WordPattern::STORED)) return;
+        config.wordA_switches[0] = pattern.wordA;
+        config.wordB_switches[0] = pattern.wordB;
+        config.wordLength = pattern.wordLength;
+        config.is16BitMode = !(pattern.flags & WordPattern::MODE_32_BIT);
+    }
+
+    // Hex string with HEX_CHARS per pattern, trailing empty slots dropped
+    std::string toHex() const {
+        int used = NUM_PATTERNS;
+        while (used > 0 && !isStored(used - 1)) used--;
+        std::string hex;
+        hex.reserve(used * HEX_CHARS);
+        char buffer[HEX_CHARS + 1];
+        for (int i = 0; i < used; i++) {
+            const WordPattern& pattern = patterns[i];
+            std::snprintf(buffer, sizeof(buffer), "%04x%04x%02x%02x", pattern.wordA, pattern.wordB, pattern.wordLength, pattern.flags);
+            hex += buffer;
+        }
+        return hex;
+    }
+
+    // Loads what toHex() wrote. Malformed entries are left empty.
+    void fromHex(const std::string& hex) {
+        clearAll();
+        int count = std::min((int)(hex.size() / HEX_CHARS), (int)NUM_PATTERNS);
+        for (int i = 0; i < count; i++) {
+            unsigned wordA, wordB, wordLength, flags;
+            if (std::sscanf(hex.c_str() + i * HEX_CHARS, "%4x%4x%2x%2x", &wordA, &wordB, &wordLength, &flags) != 4) continue;
+            if (wordLength < 1 || wordLength > 16) continue;
+            WordPattern& pattern = patterns[i];
+            pattern.wordA = (uint16_t)wordA;
+            pattern.wordB = (uint16_t)wordB;
+            pattern.wordLength = (uint8_t)wordLength;
+            pattern.flags = (uint8_t)flags;
+        }
+    }
+};
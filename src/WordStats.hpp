@@ -0,0 +1,42 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Runtime counters of one WordGenerator. The audio thread is the only writer; the context menu
+// and dataToJson() read them concurrently, hence relaxed atomics throughout.
+struct WordStats {
+    struct Counter {
+        std::atomic<uint64_t> value{0};
+        // Single writer, so a plain load/store pair instead of a locked read-modify-write
+        void add(uint64_t n) { value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+        uint64_t get() const { return value.load(std::memory_order_relaxed); }
+        void clear() { value.store(0, std::memory_order_relaxed); }
+    };
+
+    Counter ticks;               // Steps advanced, all channels
+    Counter prnDraws;            // Bernoulli masks drawn for the PRN/switch mixing
+    Counter singleCycles;        // Single cycles run to completion
+    Counter missedEdges;         // External clock edges ignored because the channel was stopped
+    Counter mergedEdges;         // External clock edges within a pulse length of the previous tick, whose pulses merge
+    Counter processCalls;        // Published in steps of PROFILE_INTERVAL, at the timed calls
+    Counter profiledCalls;       // process() calls timed, one in PROFILE_INTERVAL
+    Counter profiledNanoseconds;
+    Counter bitsCompared;        // BERT: received bits checked while in sync, all channels
+    Counter bitErrors;
+    std::atomic<int> bertDelay{-1};          // BERT round trip of channel 1 in ticks, -1 while searching
+    std::atomic<float> ticksPerSecond{0.f}; // Over the last full second
+    std::atomic<bool> clearRequested{false}; // Set by the UI, carried out by the audio thread
+
+    void clear() {
+        ticks.clear(); prnDraws.clear(); singleCycles.clear(); missedEdges.clear(); mergedEdges.clear();
+        processCalls.clear(); profiledCalls.clear(); profiledNanoseconds.clear();
+        bitsCompared.clear(); bitErrors.clear();
+        ticksPerSecond.store(0.f, std::memory_order_relaxed);
+    }
+
+    // Mean cost of a timed process() call
+    double nanosecondsPerCall() const {
+        uint64_t calls = profiledCalls.get();
+        return calls ? (double)profiledNanoseconds.get() / calls : 0.0;
+    }
+};
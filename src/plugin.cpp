@@ -1,5 +1,6 @@
 #include "plugin.hpp"
 #include "WordGenerator.hpp"
+#include "WordExpander.hpp"
 
 
 Plugin* pluginInstance;
@@ -10,6 +11,7 @@ void init(Plugin* p) {
 
 	// Add modules here
 	p->addModel(modelWordGenerator);
+	p->addModel(modelWordExpander);
 
 	// Any other plugin initialization may go here.
 	// As an alternative, consider lazy-loading assets and lookup tables when your module is created to reduce startup times of Rack.
@@ -0,0 +1,310 @@
+// Word Generator core benchmark.
+// Drives the Rack-free WordEngine per sample the way the module does (scheduled internal clock
+// with quiet-sample skipping, or Schmitt-triggered external clock; run state, pulses and output
+// bits every sample) across a matrix of configurations, and reports ns/sample and ns/tick.
+// With --baseline it compares against stored numbers and exits non-zero on a regression: any case
+// or any axis value (clock, mode, length, PRN probability, instance count) that got slower than its budget.
+//
+// Build and run with `make bench`; record the stored numbers with `make bench-baseline`.
+#include "../src/WordEngine.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    size_t samples = 1 << 16;       // Per instance and repetition
+    int repetitions = 5;            // Best of
+    int retries = 3;                // Passes re-measuring the cases over budget, which only fail if they stay there
+    float caseTolerance = 0.25f;    // Allowed slowdown of any single case against the baseline, as a fraction
+    float axisTolerance = 0.2f;     // Allowed slowdown of the geometric mean over the cases sharing an axis value
+    float slackNs = 0.5f;           // Absolute ns/sample allowance per case, for cases near the timer's resolution
+    const char* filter = nullptr;
+    const char* baselinePath = nullptr;
+    const char* writeBaselinePath = nullptr;
+};
+
+struct Case {
+    std::string name;
+    std::vector<std::string> axes; // The axis values the name is made of
+    WordEngine::Config config;
+    bool externalClock = false;
+    float clockRate = 1000.f;
+    int instances = 1;
+};
+
+struct Result {
+    double nsPerSample = 0.0; // Per instance
+    double nsPerTick = 0.0;
+    uint64_t ticks = 0;
+};
+
+const float SAMPLE_RATE = 48000.f;
+
+void printUsage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  --samples N              Samples per instance and repetition (default 65536)\n"
+        "  --repetitions N          Best of N runs per case (default 5)\n"
+        "  --filter TEXT            Only run cases whose name contains TEXT\n"
+        "  --baseline FILE          Compare against FILE, exit 1 on a regression\n"
+        "  --case-tolerance F       Allowed slowdown of any single case (default 0.25 = 25%%)\n"
+        "  --axis-tolerance F       Allowed slowdown of the geometric mean per axis value, e.g. all prn0.5 cases (default 0.2 = 20%%)\n"
+        "  --retries N              Re-measure the cases over budget in up to N further passes before failing them (default 3)\n"
+        "  --write-baseline FILE    Store the results in FILE\n",
+        argv0);
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") return false;
+        if (i + 1 >= argc) { std::fprintf(stderr, "Missing value for %s\n", arg.c_str()); return false; }
+        const char* value = argv[++i];
+        if (arg == "--samples") options.samples = std::strtoull(value, nullptr, 0);
+        else if (arg == "--repetitions") options.repetitions = std::max(1, std::atoi(value));
+        else if (arg == "--filter") options.filter = value;
+        else if (arg == "--baseline") options.baselinePath = value;
+        else if (arg == "--case-tolerance") options.caseTolerance = (float)std::atof(value);
+        else if (arg == "--axis-tolerance") options.axisTolerance = (float)std::atof(value);
+        else if (arg == "--retries") options.retries = std::max(0, std::atoi(value));
+        else if (arg == "--write-baseline") options.writeBaselinePath = value;
+        else { std::fprintf(stderr, "Unknown option %s\n", arg.c_str()); return false; }
+    }
+    return options.samples > 0;
+}
+
+std::vector<std::string> splitName(const std::string& name) {
+    std::vector<std::string> parts;
+    size_t begin = 0;
+    for (size_t end; (end = name.find('-', begin)) != std::string::npos; begin = end + 1) parts.push_back(name.substr(begin, end - begin));
+    parts.push_back(name.substr(begin));
+    return parts;
+}
+
+std::vector<Case> buildCases() {
+    std::vector<Case> cases;
+    const float prnProbabilities[] = {0.f, 0.5f, 1.f};
+    struct Clock { const char* name; bool external; float rate; };
+    // 20 kHz internal is the audio-rate range; 12 kHz external is a clock at a quarter of the sample rate
+    const Clock clocks[] = {{"int1k", false, 1000.f}, {"int20k", false, 20000.f}, {"ext1k", true, 1000.f}, {"ext12k", true, 12000.f}};
+    char name[64];
+    for (const Clock& clock : clocks) {
+        for (int mode = 16; mode <= 32; mode += 16) {
+            for (int length = 1; length <= 16; length++) {
+                for (float prn : prnProbabilities) {
+                    Case c;
+                    std::snprintf(name, sizeof(name), "%s-%db-len%02d-prn%.1f", clock.name, mode, length, prn);
+                    c.name = name;
+                    c.axes = splitName(c.name);
+                    c.config.wordA_switches[0] = 0xA5C3; c.config.wordB_switches[0] = 0x0FF0;
+                    c.config.wordLength = length;
+                    c.config.is16BitMode = mode == 16;
+                    c.config.prnProbability = prn;
+                    c.externalClock = clock.external;
+                    c.clockRate = clock.rate;
+                    cases.push_back(c);
+                }
+            }
+        }
+    }
+    // Many instances side by side, as in a large patch or a 16-channel polyphonic module
+    for (int clock = 0; clock < 3; clock += 2) {
+        for (int mode = 16; mode <= 32; mode += 16) {
+            for (float prn : prnProbabilities) {
+                Case c;
+                std::snprintf(name, sizeof(name), "%s-%db-len16-prn%.1f-x64", clocks[clock].name, mode, prn);
+                c.name = name;
+                c.axes = splitName(c.name);
+                c.config.wordA_switches[0] = 0xA5C3; c.config.wordB_switches[0] = 0x0FF0;
+                c.config.is16BitMode = mode == 16;
+                c.config.prnProbability = prn;
+                c.externalClock = clocks[clock].external;
+                c.clockRate = clocks[clock].rate;
+                c.instances = 64;
+                cases.push_back(c);
+            }
+        }
+    }
+    return cases;
+}
+
+// Per-instance state the module keeps next to each engine
+struct Instance {
+    WordEngine engine;
+    int quietSamples = 0;
+    int skippedSamples = 0;
+    bool clockHigh = false; // External clock Schmitt trigger state
+};
+
+Result runCase(const Case& c, const Options& options) {
+    float sampleTime = 1.f / SAMPLE_RATE;
+    // External clock input: square wave at the clock rate, 10 V high
+    std::vector<float> clockInput;
+    if (c.externalClock) {
+        clockInput.resize(options.samples);
+        float phase = 0.f;
+        for (size_t i = 0; i < options.samples; i++) {
+            clockInput[i] = phase < 0.5f ? 10.f : 0.f;
+            phase += c.clockRate * sampleTime;
+            phase -= (int)phase;
+        }
+    }
+
+    Result best;
+    best.nsPerSample = 1e30;
+    for (int rep = 0; rep < options.repetitions; rep++) {
+        std::vector<Instance> instances(c.instances);
+        for (int i = 0; i < c.instances; i++) {
+            instances[i].engine.reset(c.config, 1234 + i);
+            if (!c.externalClock) instances[i].engine.scheduleClock(c.clockRate, sampleTime);
+        }
+        uint64_t ticks = 0;
+        unsigned sink = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t s = 0; s < options.samples; s++) {
+            for (Instance& instance : instances) {
+                WordEngine& engine = instance.engine;
+                bool tick = false;
+                if (c.externalClock) {
+                    float v = clockInput[s];
+                    if (instance.clockHigh) { if (v <= 0.1f) instance.clockHigh = false; }
+                    else if (v >= 1.f) { instance.clockHigh = true; tick = true; }
+                } else if (instance.quietSamples > 0) {
+                    instance.quietSamples--;
+                    instance.skippedSamples++;
+                } else {
+                    if (instance.skippedSamples > 0) engine.advanceScheduledClock(instance.skippedSamples);
+                    instance.skippedSamples = 0;
+                    tick = engine.advanceScheduledClock(1);
+                    instance.quietSamples = engine.samplesToClockEvent() - 1;
+                }
+                engine.updateRunState(c.config);
+                if (tick) {
+                    engine.tick(c.config);
+                    ticks++;
+                }
+                WordEngine::Frame frame = engine.process(c.config, sampleTime);
+                sink += frame.bitA + 2 * frame.bitB + 4 * frame.gateA + 8 * frame.firstBit;
+            }
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        double nsPerSample = ns / ((double)options.samples * c.instances);
+        if (nsPerSample < best.nsPerSample) {
+            best.nsPerSample = nsPerSample;
+            best.nsPerTick = ticks ? ns / ticks : 0.0;
+            best.ticks = ticks;
+        }
+        if (sink == 0xFFFFFFFF) std::fprintf(stderr, " "); // Keep the outputs observable
+    }
+    return best;
+}
+
+bool readBaseline(const char* path, std::map<std::string, double>& baseline) {
+    FILE* f = std::fopen(path, "r");
+    if (!f) { std::perror(path); return false; }
+    char name[64];
+    double nsPerSample;
+    char line[256];
+    while (std::fgets(line, sizeof(line), f)) {
+        if (line[0] == '#') continue;
+        if (std::sscanf(line, "%63s %lf", name, &nsPerSample) == 2) baseline[name] = nsPerSample;
+    }
+    std::fclose(f);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) { printUsage(argv[0]); return 2; }
+
+    std::map<std::string, double> baseline;
+    if (options.baselinePath && !readBaseline(options.baselinePath, baseline)) return 2;
+
+    FILE* baselineOut = nullptr;
+    if (options.writeBaselinePath) {
+        baselineOut = std::fopen(options.writeBaselinePath, "w");
+        if (!baselineOut) { std::perror(options.writeBaselinePath); return 2; }
+        std::fprintf(baselineOut, "# wordbench baseline: case ns/sample (per instance), %zu samples, best of %d\n", options.samples, options.repetitions);
+    }
+
+    std::vector<Case> cases;
+    for (const Case& c : buildCases()) {
+        if (!options.filter || c.name.find(options.filter) != std::string::npos) cases.push_back(c);
+    }
+    std::vector<Result> results;
+    for (const Case& c : cases) results.push_back(runCase(c, options));
+    // Slow spells on a shared machine last seconds, so cases over budget are measured again in
+    // later passes rather than straight away, keeping their best result
+    auto overBudget = [&](size_t i) {
+        auto it = baseline.find(cases[i].name);
+        return it != baseline.end() && results[i].nsPerSample > it->second * (1.0 + options.caseTolerance) + options.slackNs;
+    };
+    for (int retry = 0; retry < options.retries; retry++) {
+        bool any = false;
+        for (size_t i = 0; i < cases.size(); i++) {
+            if (!overBudget(i)) continue;
+            Result again = runCase(cases[i], options);
+            if (again.nsPerSample < results[i].nsPerSample) results[i] = again;
+            any = true;
+        }
+        if (!any) break;
+    }
+
+    std::printf("%-32s %10s %10s %10s %10s\n", "case", "ns/sample", "ns/tick", "baseline", "change");
+    int regressions = 0;
+    int compared = 0;
+    std::map<std::string, std::pair<double, int>> axisLogRatios; // Per axis value: sum of log(ns / baseline ns), cases
+    double totalNs = 0.0;
+    for (size_t i = 0; i < cases.size(); i++) {
+        const Case& c = cases[i];
+        const Result& result = results[i];
+        auto it = baseline.find(c.name);
+        totalNs += result.nsPerSample;
+        std::printf("%-32s %10.2f %10.1f", c.name.c_str(), result.nsPerSample, result.nsPerTick);
+        if (it != baseline.end()) {
+            compared++;
+            double change = result.nsPerSample / it->second - 1.0;
+            for (const std::string& axis : c.axes) {
+                axisLogRatios[axis].first += std::log(result.nsPerSample / it->second);
+                axisLogRatios[axis].second++;
+            }
+            bool regressed = overBudget(i);
+            std::printf(" %10.2f %+9.0f%%%s", it->second, change * 100.0, regressed ? "  REGRESSION" : "");
+            if (regressed) regressions++;
+        }
+        std::printf("\n");
+        if (baselineOut) std::fprintf(baselineOut, "%s %.3f\n", c.name.c_str(), result.nsPerSample);
+    }
+    std::printf("Sum of ns/sample over all cases: %.1f\n", totalNs);
+    if (baselineOut) std::fclose(baselineOut);
+
+    if (options.baselinePath && compared > 0) {
+        // Geometric mean change per axis value, so that a slowdown spread thinly over a whole axis
+        // (say every 32-bit case) fails even where no single case crosses its limit
+        int axisRegressions = 0;
+        std::printf("%-32s %10s\n", "axis value", "change");
+        for (const auto& axis : axisLogRatios) {
+            double change = std::exp(axis.second.first / axis.second.second) - 1.0;
+            bool regressed = change > options.axisTolerance;
+            std::printf("%-32s %+9.1f%%%s\n", axis.first.c_str(), change * 100.0, regressed ? "  REGRESSION" : "");
+            if (regressed) axisRegressions++;
+        }
+        std::printf("%d of %d cases slower than the per-case limit of %+.0f%%\n", regressions, compared, options.caseTolerance * 100.f);
+        std::printf("%d of %d axis values slower than the per-axis limit of %+.0f%%\n", axisRegressions, (int)axisLogRatios.size(), options.axisTolerance * 100.f);
+        if (regressions > 0 || axisRegressions > 0) return 1;
+    }
+    return 0;
+}
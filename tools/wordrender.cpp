@@ -0,0 +1,165 @@
+// Headless Word Generator renderer.
+// Drives the Rack-free WordEngine in large batches to produce long test sequences offline,
+// either as a packed raw bitstream (one entry per clock tick) or as a stereo float WAV file
+// of the Word A/B CV outputs at a given sample rate and internal clock rate.
+//
+// A raw bitstream can be fed back in with --play, as the module's bitstream playback does.
+//
+// Build with `make wordrender`, then e.g.
+//     build/tools/wordrender --steps 10000000 --word-a 0xF0F0 --prn 0.25 --seed 42 out.bin
+#include "../src/Bitstream.hpp"
+#include "../src/WordEngine.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    WordEngine::Config config;
+    uint64_t steps = 1000000;
+    uint64_t start = 0;
+    uint64_t seed = 0;
+    bool seeded = false;
+    bool wav = false;
+    float sampleRate = 48000.f;
+    float clockRate = 1000.f;
+    size_t batchSize = 1 << 16;
+    const char* outputPath = nullptr;
+    const char* playPath = nullptr;
+};
+
+void printUsage(const char* argv0) {
+    std::fprintf(stderr,
+        "Usage: %s [options] OUTPUT\n"
+        "  --steps N          Number of clock ticks to render (default 1000000)\n"
+        "  --format raw|wav   raw: 2 bits per tick (bit 0 Word A, bit 1 Word B), 4 ticks per byte, LSB first\n"
+        "                     wav: 32-bit float stereo of the A/B CV outputs, 10 V = 1.0 (default raw)\n"
+        "  --word-a HEX       Word A switches (default 0x0000)\n"
+        "  --word-b HEX       Word B switches (default 0x0000)\n"
+        "  --length N         Word length 1..16 (default 16)\n"
+        "  --mode 16|32       16-bit or interleaved 32-bit mode (default 16)\n"
+        "  --prn P            PRN probability 0..1 (default 0)\n"
+        "  --invert-a         Invert Word A\n"
+        "  --invert-b         Invert Word B\n"
+        "  --seed N           Seed for the LFSR and the PRN mixing (default: time based)\n"
+        "  --play FILE        Take the words from a raw bitstream FILE instead of the switches\n"
+        "  --start N          Start at tick N of the seeded sequence, jumping there in O(log N) (default 0)\n"
+        "  --sample-rate HZ   WAV sample rate (default 48000)\n"
+        "  --clock-rate HZ    WAV internal clock rate (default 1000)\n"
+        "  --batch N          Render buffer size in ticks or frames (default 65536)\n",
+        argv0);
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--invert-a") options.config.invertA = true;
+        else if (arg == "--invert-b") options.config.invertB = true;
+        else if (arg == "--help" || arg == "-h") return false;
+        else if (arg.compare(0, 2, "--") == 0) {
+            if (!hasValue) { std::fprintf(stderr, "Missing value for %s\n", arg.c_str()); return false; }
+            const char* value = argv[++i];
+            if (arg == "--steps") options.steps = std::strtoull(value, nullptr, 0);
+            else if (arg == "--format") {
+                if (std::strcmp(value, "wav") == 0) options.wav = true;
+                else if (std::strcmp(value, "raw") == 0) options.wav = false;
+                else { std::fprintf(stderr, "Unknown format %s\n", value); return false; }
+            }
+            else if (arg == "--word-a") options.config.wordA_switches[0] = (uint16_t)std::strtoul(value, nullptr, 16);
+            else if (arg == "--word-b") options.config.wordB_switches[0] = (uint16_t)std::strtoul(value, nullptr, 16);
+            else if (arg == "--length") options.config.wordLength = std::atoi(value);
+            else if (arg == "--mode") options.config.is16BitMode = std::atoi(value) != 32;
+            else if (arg == "--prn") options.config.prnProbability = (float)std::atof(value);
+            else if (arg == "--play") options.playPath = value;
+            else if (arg == "--start") options.start = std::strtoull(value, nullptr, 0);
+            else if (arg == "--seed") { options.seed = std::strtoull(value, nullptr, 0); options.seeded = true; }
+            else if (arg == "--sample-rate") options.sampleRate = (float)std::atof(value);
+            else if (arg == "--clock-rate") options.clockRate = (float)std::atof(value);
+            else if (arg == "--batch") options.batchSize = std::strtoull(value, nullptr, 0);
+            else { std::fprintf(stderr, "Unknown option %s\n", arg.c_str()); return false; }
+        }
+        else if (!options.outputPath) options.outputPath = argv[i];
+        else { std::fprintf(stderr, "Unexpected argument %s\n", argv[i]); return false; }
+    }
+    if (!options.outputPath) return false;
+    if (options.config.wordLength < 1 || options.config.wordLength > 16) { std::fprintf(stderr, "Word length must be 1..16\n"); return false; }
+    if (options.config.prnProbability < 0.f || options.config.prnProbability > 1.f) { std::fprintf(stderr, "PRN probability must be 0..1\n"); return false; }
+    if (options.sampleRate <= 0.f || options.clockRate <= 0.f || options.clockRate > options.sampleRate) { std::fprintf(stderr, "Clock rate must be positive and at most the sample rate\n"); return false; }
+    if (options.batchSize < 4) options.batchSize = 4;
+    options.batchSize &= ~(size_t)3; // Keep raw batches byte aligned
+    return true;
+}
+
+void writeU16(FILE* f, uint16_t v) { uint8_t b[2] = {(uint8_t)v, (uint8_t)(v >> 8)}; std::fwrite(b, 1, 2, f); }
+void writeU32(FILE* f, uint32_t v) { uint8_t b[4] = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)}; std::fwrite(b, 1, 4, f); }
+
+// IEEE float WAV header, 2 channels
+void writeWavHeader(FILE* f, uint32_t sampleRate, uint64_t frames) {
+    uint64_t dataBytes = frames * 2 * sizeof(float);
+    if (dataBytes > 0xFFFFFFFFull - 36) dataBytes = 0xFFFFFFFFull - 36; // RIFF size limit, readers fall back to file length
+    std::fwrite("RIFF", 1, 4, f); writeU32(f, (uint32_t)(36 + dataBytes)); std::fwrite("WAVE", 1, 4, f);
+    std::fwrite("fmt ", 1, 4, f); writeU32(f, 16);
+    writeU16(f, 3); writeU16(f, 2); writeU32(f, sampleRate); writeU32(f, sampleRate * 2 * sizeof(float));
+    writeU16(f, 2 * sizeof(float)); writeU16(f, 32);
+    std::fwrite("data", 1, 4, f); writeU32(f, (uint32_t)dataBytes);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) { printUsage(argv[0]); return 1; }
+
+    BitstreamFile stream;
+    if (options.playPath) {
+        if (!stream.open(options.playPath)) { std::fprintf(stderr, "Can't map %s\n", options.playPath); return 1; }
+        options.config.streamWords = stream.words();
+        options.config.streamTicks = stream.ticks();
+    }
+
+    FILE* out = std::fopen(options.outputPath, "wb");
+    if (!out) { std::perror(options.outputPath); return 1; }
+
+    uint64_t seed = options.seeded ? options.seed : (uint64_t)std::time(nullptr);
+    WordEngine engine;
+    engine.reset(options.config, seed);
+    if (options.start > 0) engine.seek(options.config, options.start);
+
+    std::clock_t start = std::clock();
+    bool ok = true;
+    if (!options.wav) {
+        std::vector<uint8_t> buffer(options.batchSize / 4);
+        for (uint64_t done = 0; done < options.steps && ok;) {
+            size_t n = (size_t)std::min<uint64_t>(options.batchSize, options.steps - done);
+            engine.renderSteps(options.config, buffer.data(), n);
+            size_t bytes = (n + 3) / 4;
+            ok = std::fwrite(buffer.data(), 1, bytes, out) == bytes;
+            done += n;
+        }
+    } else {
+        float sampleTime = 1.f / options.sampleRate;
+        uint64_t frames = (uint64_t)((double)options.steps * options.sampleRate / options.clockRate);
+        writeWavHeader(out, (uint32_t)options.sampleRate, frames);
+        std::vector<float> buffer(options.batchSize * 2);
+        for (uint64_t done = 0; done < frames && ok;) {
+            size_t n = (size_t)std::min<uint64_t>(options.batchSize, frames - done);
+            engine.renderFrames(options.config, options.clockRate, sampleTime, buffer.data(), n);
+            for (size_t i = 0; i < 2 * n; i++) buffer[i] *= 0.1f; // 10 V full scale
+            ok = std::fwrite(buffer.data(), sizeof(float), 2 * n, out) == 2 * n;
+            done += n;
+        }
+    }
+    if (std::fclose(out) != 0) ok = false;
+    if (!ok) { std::fprintf(stderr, "Write to %s failed\n", options.outputPath); return 1; }
+
+    double seconds = (double)(std::clock() - start) / CLOCKS_PER_SEC;
+    std::fprintf(stderr, "Rendered %llu ticks in %.3f s (seed %llu)\n", (unsigned long long)options.steps, seconds, (unsigned long long)seed);
+    return 0;
+}